@@ -0,0 +1,2260 @@
+#define OLC_PGE_APPLICATION
+#include "ChunkStreamer.h"
+#include "DistanceField.h"
+#include "FrameArena.h"
+#include "HudText.h"
+#include "JobSystem.h"
+#include "Map.h"
+#include "MapFile.h"
+#include "OccupancyGrid.h"
+#include "Player.h"
+#include "RayTrace.h"
+#include "Simulation.h"
+#include "Texture.h"
+#include "Trace.h"
+#include "TripleBuffer.h"
+#include "Utils.h"
+#include "Log.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+//-------------------------------------------------
+// Allocation counter
+//-------------------------------------------------
+
+static std::atomic<std::size_t> g_allocations{ 0 };
+
+/**
+ * @brief Counts and serves every replaceable operator new.
+ *
+ * Kept out of line with its counterpart, so the compiler never pairs an inlined
+ * free() with the operator new a pointer came from.
+ */
+[[gnu::noinline]] static void* counted_allocate(const std::size_t t_size, const std::size_t t_alignment)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    // aligned_alloc() wants a multiple of the alignment
+    const auto size{ std::max(t_size, std::size_t{ 1 }) };
+    auto* ptr{
+        t_alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__
+            ? std::aligned_alloc(t_alignment, (size + t_alignment - 1) / t_alignment * t_alignment)
+            : std::malloc(size)
+    };
+    if (!ptr)
+    {
+        throw std::bad_alloc{};
+    }
+
+    return ptr;
+}
+
+[[gnu::noinline]] static void counted_free(void* t_ptr) noexcept
+{
+    std::free(t_ptr);
+}
+
+void* operator new(const std::size_t t_size)
+{
+    return counted_allocate(t_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](const std::size_t t_size)
+{
+    return counted_allocate(t_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(const std::size_t t_size, const std::align_val_t t_alignment)
+{
+    return counted_allocate(t_size, static_cast<std::size_t>(t_alignment));
+}
+
+void* operator new[](const std::size_t t_size, const std::align_val_t t_alignment)
+{
+    return counted_allocate(t_size, static_cast<std::size_t>(t_alignment));
+}
+
+void operator delete(void* t_ptr) noexcept
+{
+    counted_free(t_ptr);
+}
+
+void operator delete[](void* t_ptr) noexcept
+{
+    counted_free(t_ptr);
+}
+
+void operator delete(void* t_ptr, std::size_t) noexcept
+{
+    counted_free(t_ptr);
+}
+
+void operator delete[](void* t_ptr, std::size_t) noexcept
+{
+    counted_free(t_ptr);
+}
+
+void operator delete(void* t_ptr, std::align_val_t) noexcept
+{
+    counted_free(t_ptr);
+}
+
+void operator delete[](void* t_ptr, std::align_val_t) noexcept
+{
+    counted_free(t_ptr);
+}
+
+void operator delete(void* t_ptr, std::size_t, std::align_val_t) noexcept
+{
+    counted_free(t_ptr);
+}
+
+void operator delete[](void* t_ptr, std::size_t, std::align_val_t) noexcept
+{
+    counted_free(t_ptr);
+}
+
+//-------------------------------------------------
+// Config
+//-------------------------------------------------
+
+/**
+ * @brief The directory holding level1.map; the source tree, so the checks don't depend on the working directory.
+ */
+#ifdef FPS_SOURCE_DIR
+constexpr const char* DATA_DIR{ FPS_SOURCE_DIR };
+#else
+constexpr const char* DATA_DIR{ "." };
+#endif
+
+/**
+ * @brief Creates a config snapshot without reading the Ini-File.
+ */
+static Config create_config(const int t_width, const int t_height, const int t_nrOfRays, const int t_fovDeg, const int t_startTile = 4)
+{
+    inih::INIReader ini;
+    ini.InsertEntry("window", "width", t_width);
+    ini.InsertEntry("window", "height", t_height);
+    ini.InsertEntry("map", "file", std::string{ DATA_DIR } + "/level1.map");
+    ini.InsertEntry("map", "tile_size", 64);
+    ini.InsertEntry("map", "projection_plane", 48);
+    ini.InsertEntry("stream", "enabled", 0);
+    ini.InsertEntry("stream", "chunk_size", 64);
+    ini.InsertEntry("stream", "view_distance", 64);
+    ini.InsertEntry("stream", "max_resident_chunks", 64);
+    ini.InsertEntry("mini_map", "scale", 0.25f);
+    ini.InsertEntry("mini_map", "tiles", 16);
+    ini.InsertEntry("player", "line_length", 12);
+    ini.InsertEntry("player", "fov", t_fovDeg);
+    ini.InsertEntry("player", "nr_of_rays", t_nrOfRays);
+    ini.InsertEntry("player", "simd", 1);
+    ini.InsertEntry("player", "cast_mode", std::string{ "grid" });
+    ini.InsertEntry("player", "turn_speed", 2);
+    ini.InsertEntry("player", "move_speed", 64);
+    ini.InsertEntry("player", "start_x", t_startTile);
+    ini.InsertEntry("player", "start_y", t_startTile);
+    ini.InsertEntry("simulation", "tick_rate", 120);
+    ini.InsertEntry("texture", "mipmapping", 1);
+    ini.InsertEntry("texture", "mip_bias", 0);
+    ini.InsertEntry("threads", "workers", 1);
+    ini.InsertEntry("threads", "chunk_size", 32);
+    ini.InsertEntry("threads", "deterministic", 0);
+    ini.InsertEntry("trace", "enabled", 0);
+    ini.InsertEntry("trace", "file", std::string{ "trace.json" });
+
+    return Config{ ini };
+}
+
+//-------------------------------------------------
+// Steady-state allocations
+//-------------------------------------------------
+
+/**
+ * @brief Casts frames after a warm-up frame and checks that no heap allocation happens.
+ *
+ * @return False if a steady-state frame allocates.
+ */
+static bool check_cast_rays_allocations()
+{
+    const auto config{ create_config(1920, 1080, 1920, 60) };
+    JobSystem jobs{ config.threads.workers, config.threads.deterministic };
+    const Map map{ config };
+    Player player{ config, map };
+
+    player.CastRays(jobs);
+
+    constexpr auto frames{ 100 };
+    const auto before{ g_allocations.load() };
+    for (auto frame{ 0 }; frame < frames; ++frame)
+    {
+        player.radians = clamp_radians(player.radians + 0.01f);
+        player.CastRays(jobs);
+    }
+    const auto allocations{ g_allocations.load() - before };
+
+    std::printf("cast_rays steady-state allocations: %zu in %d frames\n", allocations, frames);
+
+    return allocations == 0;
+}
+
+/**
+ * @brief Builds frame-arena strings and vectors for some frames and checks alignment, overflow and that no frame allocates.
+ */
+static bool check_frame_arena()
+{
+    FrameArena arena{ 1024 };
+    auto ok{ true };
+
+    constexpr auto frames{ 100 };
+    const auto before{ g_allocations.load() };
+    for (auto frame{ 0 }; frame < frames; ++frame)
+    {
+        arena.Reset();
+
+        FrameVector<double> values{ FrameAllocator<double>{ arena } };
+        for (auto i{ 0 }; i < 16; ++i)
+        {
+            values.push_back(i * 0.5);
+        }
+        char number[32];
+        FrameString text{ "frame ", FrameAllocator<char>{ arena } };
+        text.append(number, std::to_chars(number, number + sizeof(number), frame).ptr);
+        text += ", value ";
+        text.append(number, std::to_chars(number, number + sizeof(number), values.back(), std::chars_format::fixed, 3).ptr);
+
+        ok = reinterpret_cast<std::uintptr_t>(values.data()) % alignof(double) == 0 && ok;
+        char expected[32];
+        std::snprintf(expected, sizeof(expected), "frame %d, value 7.500", frame);
+        ok = text == expected && ok;
+    }
+    const auto allocations{ g_allocations.load() - before };
+
+    // a request beyond the capacity goes to the heap and is freed there
+    const auto highWaterMark{ arena.GetUsed() };
+    {
+        FrameVector<char> large(2048, 'x', FrameAllocator<char>{ arena });
+        ok = large.back() == 'x' && arena.GetOverflowCount() == 1 && arena.GetUsed() == highWaterMark && ok;
+    }
+    arena.Reset();
+    ok = arena.GetUsed() == 0 && ok;
+
+    std::printf(
+        "frame_arena: %s (%zu allocations in %d frames, %zu of %zu bytes used)\n",
+        ok && allocations == 0 ? "ok" : "FAILED", allocations, frames, highWaterMark, arena.GetCapacity()
+    );
+
+    return ok && allocations == 0;
+}
+
+/**
+ * @brief A font sheet in the layout of the engine font; the engine only builds its own with a renderer.
+ */
+static std::unique_ptr<olc::Sprite> create_font()
+{
+    auto font{ std::make_unique<olc::Sprite>(16 * HudText::GLYPH_SIZE, 6 * HudText::GLYPH_SIZE) };
+    for (auto y{ 0 }; y < font->height; ++y)
+    {
+        for (auto x{ 0 }; x < font->width; ++x)
+        {
+            const auto set{ (x * 7 + y * 3 + x / HudText::GLYPH_SIZE) % 5 < 2 };
+            font->SetPixel(x, y, set ? olc::WHITE : olc::BLANK);
+        }
+    }
+
+    return font;
+}
+
+/**
+ * @brief Draws text glyph by glyph from the font sheet, like olc::PixelGameEngine::DrawString().
+ */
+static void draw_reference_text(olc::Sprite& t_target, const olc::Sprite& t_font, const int t_x, const int t_y, const std::string_view t_text, const olc::Pixel t_color)
+{
+    for (auto i{ 0 }; i < static_cast<int>(t_text.size()); ++i)
+    {
+        const auto glyph{ t_text[i] - HudText::FIRST_GLYPH };
+        for (auto row{ 0 }; row < HudText::GLYPH_SIZE; ++row)
+        {
+            for (auto column{ 0 }; column < HudText::GLYPH_SIZE; ++column)
+            {
+                if (t_font.GetPixel((glyph % 16) * HudText::GLYPH_SIZE + column, (glyph / 16) * HudText::GLYPH_SIZE + row).r > 0)
+                {
+                    t_target.SetPixel(t_x + i * HudText::GLYPH_SIZE + column, t_y + row, t_color);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Compares HUD lines with text drawn from the font sheet, also clipped at the edges, checks
+ *        that a reused buffer isn't drawn from a stale cache and that redrawing doesn't allocate.
+ */
+static bool check_hud_text()
+{
+    const auto font{ create_font() };
+    HudText hud;
+    hud.SetFont(font.get());
+
+    olc::Sprite target{ 160, 40 };
+    olc::Sprite reference{ 160, 40 };
+
+    auto ok{ true };
+    for (const auto& [x, y] : { std::pair{ 4, 4 }, std::pair{ -13, -3 }, std::pair{ 30, 36 } })
+    {
+        std::fill_n(target.GetData(), target.width * target.height, olc::BLANK);
+        std::fill_n(reference.GetData(), reference.width * reference.height, olc::BLANK);
+
+        const auto end{ hud.Draw(&target, x, y, olc::YELLOW, HudText::Label{ "Pos: " }, -42, ", ", HudText::Fixed{ 3.14159, 3 }, " ", 0.5f) };
+        draw_reference_text(reference, *font, x, y, "Pos: -42, 3.142 0.50", olc::YELLOW);
+
+        ok = end == x + 20 * HudText::GLYPH_SIZE && ok;
+        ok = std::equal(target.GetData(), target.GetData() + target.width * target.height, reference.GetData()) && ok;
+    }
+
+    // a buffer is drawn as text, so a new content at the same address shows up
+    char name[8];
+    for (const auto* text : { "ABC", "XYZ" })
+    {
+        std::fill_n(target.GetData(), target.width * target.height, olc::BLANK);
+        std::fill_n(reference.GetData(), reference.width * reference.height, olc::BLANK);
+        std::strcpy(name, text);
+
+        hud.Draw(&target, 4, 4, olc::WHITE, static_cast<const char*>(name));
+        draw_reference_text(reference, *font, 4, 4, text, olc::WHITE);
+        ok = std::equal(target.GetData(), target.GetData() + target.width * target.height, reference.GetData()) && ok;
+    }
+
+    constexpr auto frames{ 100 };
+    const auto before{ g_allocations.load() };
+    for (auto frame{ 0 }; frame < frames; ++frame)
+    {
+        hud.Draw(&target, 4, 4, olc::WHITE, HudText::Label{ "Pos: " }, frame, ", ", frame * 0.25f);
+    }
+    const auto allocations{ g_allocations.load() - before };
+    ok = hud.GetLabelCount() == 1 && ok;
+
+    std::printf("hud_text: %s (%zu allocations in %d frames, %d labels)\n", ok && allocations == 0 ? "ok" : "FAILED", allocations, frames, hud.GetLabelCount());
+
+    return ok && allocations == 0;
+}
+
+//-------------------------------------------------
+// Ray packets
+//-------------------------------------------------
+
+/**
+ * @brief Traces a fan of rays from every free tile and returns the elapsed nanoseconds.
+ *
+ * The directions are computed up front, so only the traversal is measured.
+ */
+static double bench_ray_packets(
+    const TraceGrid& t_grid,
+    const std::vector<float>& t_dirX,
+    const std::vector<float>& t_dirY,
+    const int t_frames,
+    const bool t_simd,
+    std::vector<float>& t_lengths
+)
+{
+    const auto nrOfRays{ static_cast<int>(t_dirX.size()) };
+
+    t_lengths.clear();
+    RayPacket packet{};
+
+    const auto start{ std::chrono::steady_clock::now() };
+    for (auto frame{ 0 }; frame < t_frames; ++frame)
+    {
+        for (auto mapY{ 0 }; mapY < t_grid.height; ++mapY)
+        {
+            for (auto mapX{ 0 }; mapX < t_grid.width; ++mapX)
+            {
+                if (t_grid.IsWall(mapX, mapY))
+                {
+                    continue;
+                }
+
+                const auto origin{ map_to_screen(mapX, mapY, t_grid.tileSize) };
+
+                for (auto first{ 0 }; first < nrOfRays; first += RayPacket::SIZE)
+                {
+                    const auto count{ std::min(RayPacket::SIZE, nrOfRays - first) };
+                    std::memcpy(packet.dirX, &t_dirX[first], count * sizeof(float));
+                    std::memcpy(packet.dirY, &t_dirY[first], count * sizeof(float));
+
+                    trace_ray_packet(t_grid, origin.x, origin.y, packet, count, t_simd);
+
+                    if (frame == 0)
+                    {
+                        t_lengths.insert(t_lengths.end(), packet.length, packet.length + count);
+                    }
+                }
+            }
+        }
+    }
+
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+//-------------------------------------------------
+// Maps
+//-------------------------------------------------
+
+/**
+ * @brief Pillar spacings of the arenas: dense puts a wall into every 8x8 block,
+ *        sparse leaves most of the map open.
+ */
+constexpr int DENSE_SPACING{ 8 };
+constexpr int SPARSE_SPACING{ 64 };
+
+/**
+ * @brief Creates a walled arena with a pillar on every t_spacing-th tile.
+ */
+static std::vector<std::uint8_t> create_arena(const int t_size, const int t_spacing)
+{
+    std::vector<std::uint8_t> tiles(t_size * t_size, Map::EMPTY);
+    for (auto y{ 0 }; y < t_size; ++y)
+    {
+        for (auto x{ 0 }; x < t_size; ++x)
+        {
+            const auto border{ x == 0 || y == 0 || x == t_size - 1 || y == t_size - 1 };
+            const auto pillar{ x % t_spacing == 0 && y % t_spacing == 0 };
+            if (border || pillar)
+            {
+                tiles[calc_map_index(x, y, t_size)] = Map::WALL;
+            }
+        }
+    }
+
+    return tiles;
+}
+
+/**
+ * @brief Runs the scalar and the SIMD packet path on a map and prints ns per ray.
+ *
+ * @return False if the two paths disagree.
+ */
+static bool run_ray_packets(
+    const char* t_name,
+    const TraceGrid& t_grid,
+    const std::vector<float>& t_dirX,
+    const std::vector<float>& t_dirY,
+    const int t_frames
+)
+{
+    std::vector<float> scalarLengths;
+    std::vector<float> simdLengths;
+
+    const auto scalarNs{ bench_ray_packets(t_grid, t_dirX, t_dirY, t_frames, false, scalarLengths) };
+    const auto simdNs{ bench_ray_packets(t_grid, t_dirX, t_dirY, t_frames, true, simdLengths) };
+    const auto rays{ static_cast<double>(scalarLengths.size()) * t_frames };
+
+    std::printf("ray_packets %-10s scalar: %6.2f ns/ray\n", t_name, scalarNs / rays);
+    if (!is_simd_ray_packet_supported())
+    {
+        std::printf("ray_packets %-10s avx2:   not supported\n", t_name);
+        return true;
+    }
+
+    const auto identical{
+        std::memcmp(scalarLengths.data(), simdLengths.data(), scalarLengths.size() * sizeof(float)) == 0
+    };
+    std::printf("ray_packets %-10s avx2:   %6.2f ns/ray (%.2fx, %s)\n",
+        t_name, simdNs / rays, scalarNs / simdNs, identical ? "identical" : "MISMATCH");
+
+    return identical;
+}
+
+/**
+ * @brief Casts the columns of a sweep of poses on the level and compares each with the
+ *        shorter of the reference intersections.
+ *
+ * @return False if a column's hit distance or side differs from the reference.
+ */
+static bool check_dda_reference()
+{
+    constexpr auto nrOfRays{ 256 };
+    constexpr auto yaws{ 16 };
+    constexpr auto offsets{ 4 };
+    constexpr auto tolerance{ 0.01f };
+
+    const auto config{ create_config(1024, 768, nrOfRays, 60) };
+    JobSystem jobs{ config.threads.workers, config.threads.deterministic };
+    const Map map{ config };
+    Player player{ config, map };
+    const auto tileSize{ config.render.tileSize };
+
+    auto columns{ 0 };
+    auto cornerColumns{ 0 };
+    auto lengthMismatches{ 0 };
+    auto sideMismatches{ 0 };
+
+    for (auto mapY{ 0 }; mapY < map.GetHeight(); ++mapY)
+    {
+        for (auto mapX{ 0 }; mapX < map.GetWidth(); ++mapX)
+        {
+            if (map.IsWallTypeAtMapPosition(mapX, mapY))
+            {
+                continue;
+            }
+
+            // several positions inside the tile, none on a tile boundary
+            for (auto i{ 0 }; i < offsets * offsets; ++i)
+            {
+                const auto screenX{ (static_cast<float>(mapX) + (static_cast<float>(i % offsets) + 0.5f) / offsets) * tileSize };
+                const auto screenY{ (static_cast<float>(mapY) + (static_cast<float>(i / offsets) + 0.5f) / offsets) * tileSize };
+                player.SetPositionsByScreenXY(screenX, screenY);
+
+                for (auto yaw{ 0 }; yaw < yaws; ++yaw)
+                {
+                    player.radians = clamp_radians(static_cast<float>(yaw) * 2.0f * static_cast<float>(M_PI) / yaws + 0.01f);
+                    player.CastRays(jobs);
+
+                    for (auto column{ 0 }; column < nrOfRays; ++column)
+                    {
+                        const auto radians{ clamp_radians(player.rays.GetRadians()[column]) };
+                        Ray vertical{ radians, Ray::VERTICAL };
+                        Ray horizontal{ radians, Ray::HORIZONTAL };
+                        player.GetVerticalIntersection(vertical);
+                        player.GetHorizontalIntersection(horizontal);
+                        const auto& reference{ vertical.length < horizontal.length ? vertical : horizontal };
+
+                        const auto length{ player.rays.GetLengths()[column] };
+                        const auto hitX{ player.rays.GetHitX()[column] };
+                        const auto hitY{ player.rays.GetHitY()[column] };
+
+                        // a ray through the exact corner of a wall may pass or hit; both methods are right
+                        const auto onCorner{
+                            fabsf(remainderf(hitX, tileSize)) < tolerance * tileSize &&
+                            fabsf(remainderf(hitY, tileSize)) < tolerance * tileSize
+                        };
+                        if (onCorner)
+                        {
+                            ++cornerColumns;
+                        }
+                        else if (fabsf(reference.length - length) > tolerance * tileSize)
+                        {
+                            ++lengthMismatches;
+                        }
+                        else if (reference.type != player.rays.GetTypes()[column])
+                        {
+                            ++sideMismatches;
+                        }
+
+                        ++columns;
+                    }
+                }
+            }
+        }
+    }
+
+    const auto ok{ columns > 0 && lengthMismatches == 0 && sideMismatches == 0 };
+    std::printf("dda_reference: %s (%d columns, %d on a wall corner, %d lengths and %d sides differ)\n",
+        ok ? "ok" : "FAILED", columns, cornerColumns, lengthMismatches, sideMismatches);
+
+    return ok;
+}
+
+/**
+ * @brief Compares the wall bits with the tiles on maps whose sides aren't multiples of the block size.
+ *
+ * @return False if a bit differs from its tile.
+ */
+static bool check_occupancy_grid()
+{
+    auto ok{ true };
+    for (const auto& [width, height] : { std::pair{ 64, 64 }, std::pair{ 61, 37 }, std::pair{ 3, 130 } })
+    {
+        // a pseudo-random layout, so every bit position is covered
+        std::vector<std::uint8_t> tiles(static_cast<std::size_t>(width) * height);
+        std::uint32_t state{ 12345 };
+        for (auto& tile : tiles)
+        {
+            state = state * 1664525u + 1013904223u;
+            tile = (state >> 28) < 5 ? Map::WALL : Map::EMPTY;
+        }
+
+        OccupancyGrid occupancy;
+        occupancy.Build(tiles.data(), width, height);
+        for (auto y{ -1 }; y <= height; ++y)
+        {
+            for (auto x{ -1 }; x <= width; ++x)
+            {
+                const auto onMap{ is_position_on_map(x, y, width, height) };
+                const auto expected{ !onMap || tiles[calc_map_index(x, y, width)] == Map::WALL };
+                ok = occupancy.IsWall(x, y) == expected && ok;
+            }
+        }
+    }
+
+    std::printf("occupancy_grid: %s\n", ok ? "ok" : "FAILED");
+
+    return ok;
+}
+
+/**
+ * @brief Traces rays in all directions from tiles spread over dense and sparse arenas
+ *        with the occupancy pyramid, with the distance field, tile by tile and with the
+ *        reference intersections.
+ *
+ * @return False if a jump over empty space ends anywhere else than the tile by tile walk,
+ *         or a hit differs from the shorter reference intersection.
+ */
+static bool check_jumps()
+{
+    constexpr auto nrOfRays{ 720 };
+    constexpr auto tolerance{ 0.01f };
+
+    auto ok{ true };
+    auto rays{ 0 };
+    auto referenceMismatches{ 0 };
+    auto cornerRays{ 0 };
+
+    for (const auto& [size, spacing] : { std::pair{ 256, DENSE_SPACING }, std::pair{ 256, SPARSE_SPACING }, std::pair{ 300, SPARSE_SPACING } })
+    {
+        const auto mapConfig{ create_config(1920, 1080, nrOfRays, 60) };
+        const Map map{ mapConfig, size, size, create_arena(size, spacing) };
+        const auto tileSize{ mapConfig.render.tileSize };
+
+        const auto grid{ map.GetTraceGrid() };
+        auto steps{ grid };
+        steps.pyramid = nullptr;
+
+        OccupancyGrid occupancy;
+        const auto tiles{ create_arena(size, spacing) };
+        occupancy.Build(tiles.data(), size, size);
+        DistanceField field;
+        field.Build(occupancy);
+        auto fieldGrid{ steps };
+        fieldGrid.distances = field.GetDistances();
+
+        // origins along the diagonal, the player's reference intersections start there too
+        for (auto tile{ 3 }; tile < size - 1; tile += 37)
+        {
+            if (map.IsWallTypeAtMapPosition(tile, tile))
+            {
+                continue;
+            }
+
+            const auto playerConfig{ create_config(1920, 1080, nrOfRays, 60, tile) };
+            const Player player{ playerConfig, map };
+            const auto origin{ map_to_screen(tile, tile, tileSize) };
+
+            for (auto i{ 0 }; i < nrOfRays; ++i)
+            {
+                const auto radians{ static_cast<float>(i) * 2.0f * static_cast<float>(M_PI) / nrOfRays };
+                const auto dirX{ cosf(radians) };
+                const auto dirY{ sinf(radians) };
+
+                Ray jumped{ radians, Ray::VERTICAL };
+                Ray marched{ radians, Ray::VERTICAL };
+                Ray stepped{ radians, Ray::VERTICAL };
+                trace_ray(grid, origin.x, origin.y, dirX, dirY, jumped);
+                trace_ray(fieldGrid, origin.x, origin.y, dirX, dirY, marched);
+                trace_ray(steps, origin.x, origin.y, dirX, dirY, stepped);
+
+                for (const auto& [name, ray] : { std::pair{ "pyramid", &jumped }, std::pair{ "distance field", &marched } })
+                {
+                    if (std::memcmp(&ray->length, &stepped.length, sizeof(float)) != 0 || ray->type != stepped.type)
+                    {
+                        std::printf("%s %d^2 spacing %d tile %d ray %d: %f, tile by tile %f\n",
+                            name, size, spacing, tile, i, ray->length, stepped.length);
+                        ok = false;
+                    }
+                }
+
+                Ray vertical{ clamp_radians(radians), Ray::VERTICAL };
+                Ray horizontal{ clamp_radians(radians), Ray::HORIZONTAL };
+                player.GetVerticalIntersection(vertical);
+                player.GetHorizontalIntersection(horizontal);
+                const auto& reference{ vertical.length < horizontal.length ? vertical : horizontal };
+
+                // a ray through the exact corner of a wall may pass or hit; both methods are right
+                const auto onCorner{
+                    fabsf(remainderf(jumped.screenHitPosition.x, tileSize)) < tolerance * tileSize &&
+                    fabsf(remainderf(jumped.screenHitPosition.y, tileSize)) < tolerance * tileSize
+                };
+                if (fabsf(reference.length - jumped.length) > tolerance * tileSize)
+                {
+                    ++(onCorner ? cornerRays : referenceMismatches);
+                }
+
+                ++rays;
+            }
+        }
+    }
+
+    ok = ok && referenceMismatches == 0;
+    std::printf("jumps: %s (%d rays, %d pass a wall corner differently, %d differ from the reference)\n",
+        ok ? "ok" : "FAILED", rays, cornerRays, referenceMismatches);
+
+    return ok;
+}
+
+/**
+ * @brief Traces packets with the default config the way Player::CastRays() does, on dense and
+ *        sparse arenas, and compares them with the tile by tile walk.
+ *
+ * @return False if the default config never jumps over empty space, or a ray ends anywhere
+ *         else than the tile by tile walk.
+ */
+static bool check_packet_jumps()
+{
+    constexpr auto size{ 256 };
+    constexpr auto nrOfRays{ 720 };
+
+    const auto config{ create_config(1920, 1080, nrOfRays, 60) };
+    const auto simd{ config.player.simd && config.player.castMode == CastMode::GRID };
+
+    auto ok{ simd };
+    auto jumps{ 0 };
+    for (const auto spacing : { DENSE_SPACING, SPARSE_SPACING })
+    {
+        const Map map{ config, size, size, create_arena(size, spacing) };
+        const auto grid{ map.GetTraceGrid() };
+        auto steps{ grid };
+        steps.pyramid = nullptr;
+
+        for (auto tile{ 3 }; tile < size - 1; tile += 37)
+        {
+            if (map.IsWallTypeAtMapPosition(tile, tile))
+            {
+                continue;
+            }
+
+            const auto origin{ map_to_screen(tile, tile, config.render.tileSize) };
+            for (auto first{ 0 }; first < nrOfRays; first += RayPacket::SIZE)
+            {
+                RayPacket packet{};
+                for (auto i{ 0 }; i < RayPacket::SIZE; ++i)
+                {
+                    const auto radians{ static_cast<float>(first + i) * 2.0f * static_cast<float>(M_PI) / nrOfRays };
+                    packet.dirX[i] = cosf(radians);
+                    packet.dirY[i] = sinf(radians);
+                }
+                auto stepped{ packet };
+
+                jumps += trace_ray_packet(grid, origin.x, origin.y, packet, RayPacket::SIZE, simd);
+                trace_ray_packet(steps, origin.x, origin.y, stepped, RayPacket::SIZE, false);
+
+                const auto same{
+                    std::memcmp(packet.length, stepped.length, sizeof(packet.length)) == 0 &&
+                    std::memcmp(packet.type, stepped.type, sizeof(packet.type)) == 0
+                };
+                if (!same)
+                {
+                    std::printf("packet_jumps spacing %d tile %d rays %d+: the jumps end elsewhere\n", spacing, tile, first);
+                    ok = false;
+                }
+            }
+        }
+    }
+
+    ok = ok && jumps > 0;
+    std::printf("packet_jumps: %s (%s, %d jumps)\n",
+        ok ? "ok" : "FAILED", is_simd_ray_packet_supported() ? "avx2" : "scalar", jumps);
+
+    return ok;
+}
+
+/**
+ * @brief Builds distance fields of random layouts, compares them with a brute-force search
+ *        and toggles random tiles, comparing each incremental update of the field and the
+ *        occupancy pyramid with a rebuild.
+ *
+ * @return False if a distance differs.
+ */
+static bool check_distance_field()
+{
+    auto ok{ true };
+    auto updates{ 0 };
+    for (const auto& [width, height, walls] : { std::tuple{ 61, 37, 5u }, std::tuple{ 64, 64, 1u }, std::tuple{ 300, 3, 2u } })
+    {
+        std::vector<std::uint8_t> tiles(static_cast<std::size_t>(width) * height);
+        std::uint32_t state{ 4711 };
+        const auto next{ [&] {
+            state = state * 1664525u + 1013904223u;
+            return state >> 8;
+        } };
+        for (auto& tile : tiles)
+        {
+            tile = (next() & 15) < walls ? Map::WALL : Map::EMPTY;
+        }
+
+        OccupancyGrid occupancy;
+        occupancy.Build(tiles.data(), width, height);
+        DistanceField field;
+        field.Build(occupancy);
+
+        // the distance to the nearest wall, the positions around the map included
+        for (auto y{ 0 }; y < height; ++y)
+        {
+            for (auto x{ 0 }; x < width; ++x)
+            {
+                auto expected{ std::min({ x + 1, y + 1, width - x, height - y, static_cast<int>(DistanceField::MAX_DISTANCE) }) };
+                for (auto i{ 0 }; i < width * height; ++i)
+                {
+                    if (tiles[i] == Map::WALL)
+                    {
+                        expected = std::min(expected, std::max(std::abs(i % width - x), std::abs(i / width - y)));
+                    }
+                }
+                ok = field.GetDistance(x, y) == expected && ok;
+            }
+        }
+
+        // the pyramid above the changed tile is updated too
+        OccupancyGrid rebuiltOccupancy;
+        DistanceField rebuilt;
+        for (auto i{ 0 }; i < 400; ++i)
+        {
+            const auto x{ static_cast<int>(next() % width) };
+            const auto y{ static_cast<int>(next() % height) };
+            auto& tile{ tiles[calc_map_index(x, y, width)] };
+            tile = tile == Map::WALL ? Map::EMPTY : Map::WALL;
+            occupancy.SetWall(x, y, tile == Map::WALL);
+            field.Update(occupancy, x, y);
+
+            rebuiltOccupancy.Build(tiles.data(), width, height);
+            rebuilt.Build(rebuiltOccupancy);
+            ok = std::memcmp(field.GetDistances(), rebuilt.GetDistances(), static_cast<std::size_t>(width) * height) == 0 && ok;
+            for (auto j{ 0 }; j < width * height; ++j)
+            {
+                ok = occupancy.GetEmptyLevel(j % width, j / width) == rebuiltOccupancy.GetEmptyLevel(j % width, j / width) && ok;
+            }
+            ++updates;
+        }
+    }
+
+    std::printf("distance_field: %s (%d updates)\n", ok ? "ok" : "FAILED", updates);
+
+    return ok;
+}
+
+/**
+ * @brief Traces a fan of rays from a tile through two grids, with and without the AVX2 kernel.
+ *
+ * @return False if a ray hits a different distance or tile type in the two grids.
+ */
+static bool trace_same(const TraceGrid& t_grid, const TraceGrid& t_reference, const int t_mapX, const int t_mapY)
+{
+    const auto origin{ map_to_screen(t_mapX, t_mapY, t_grid.tileSize) };
+
+    auto ok{ true };
+    for (const auto simd : { false, true })
+    {
+        for (auto first{ 0 }; first < 64; first += RayPacket::SIZE)
+        {
+            RayPacket packet{};
+            for (auto i{ 0 }; i < RayPacket::SIZE; ++i)
+            {
+                const auto angle{ static_cast<float>(first + i) / 64.0f * 2.0f * static_cast<float>(M_PI) + 0.01f };
+                packet.dirX[i] = cosf(angle);
+                packet.dirY[i] = sinf(angle);
+            }
+            auto expected{ packet };
+
+            trace_ray_packet(t_grid, origin.x, origin.y, packet, RayPacket::SIZE, simd);
+            trace_ray_packet(t_reference, origin.x, origin.y, expected, RayPacket::SIZE, simd);
+            for (auto i{ 0 }; i < RayPacket::SIZE; ++i)
+            {
+                ok = packet.length[i] == expected.length[i] && packet.type[i] == expected.type[i] && ok;
+            }
+        }
+    }
+
+    return ok;
+}
+
+/**
+ * @brief Walks a streamed arena and compares the wall bits with the tiles after every step.
+ *
+ * @return False if a resident chunk differs from its tiles, a chunk that isn't resident
+ *         isn't all walls, a ray through the chunks hits something else, a chunk in view is
+ *         missing, or more chunks are resident or hold blocks than allowed.
+ */
+static bool check_chunk_streamer()
+{
+    constexpr auto size{ 300 };
+    const auto tiles{ create_arena(size, 5) };
+
+    auto ok{ true };
+    for (const auto maxResidentChunks : { 64, 6 })
+    {
+        const StreamConfig config{ true, 32, 40, maxResidentChunks };
+        OccupancyGrid occupancy;
+        ChunkStreamer streamer{ tiles.data(), size, size, config, occupancy };
+
+        // a diagonal walk, then straight back along the top
+        for (auto step{ 0 }; step < 60; ++step)
+        {
+            const auto mapX{ step < 30 ? 5 + step * 9 : 5 + (59 - step) * 9 };
+            const auto mapY{ step < 30 ? 5 + step * 9 : 5 };
+            streamer.Update(mapX, mapY, occupancy);
+            streamer.Flush(occupancy);
+
+            const auto& metrics{ streamer.GetMetrics() };
+            ok = metrics.residentChunks <= maxResidentChunks && metrics.pendingChunks == 0 && ok;
+            for (auto y{ 0 }; y < size; ++y)
+            {
+                for (auto x{ 0 }; x < size; ++x)
+                {
+                    const auto resident{ streamer.IsResident(x, y) };
+                    const auto wall{ tiles[calc_map_index(x, y, size)] == Map::WALL };
+                    ok = occupancy.IsWall(x, y) == (wall || !resident) && ok;
+
+                    // with enough room, every tile in view is resident
+                    const auto inView{ std::max(std::abs(x - mapX), std::abs(y - mapY)) <= config.viewDistance };
+                    ok = (!inView || resident || maxResidentChunks < 64) && ok;
+                }
+            }
+            ok = (maxResidentChunks < 64 || streamer.IsResident(mapX, mapY)) && ok;
+
+            // rays through the chunk table hit what they hit in a grid built from the same walls
+            std::vector<std::uint8_t> seen(tiles.size());
+            for (auto i{ 0 }; i < size * size; ++i)
+            {
+                seen[i] = occupancy.IsWall(i % size, i / size) ? Map::WALL : Map::EMPTY;
+            }
+            OccupancyGrid reference;
+            reference.Build(seen.data(), size, size);
+            ok = trace_same(occupancy.GetTraceGrid(64.0f), reference.GetTraceGrid(64.0f), mapX, mapY) && ok;
+        }
+
+        // the blocks take room for the resident chunks and the walls chunk, not for the map
+        const auto chunkWords{ static_cast<std::size_t>(config.chunkSize / OccupancyGrid::BLOCK_SIZE) * (config.chunkSize / OccupancyGrid::BLOCK_SIZE) };
+        const auto chunkCount{ static_cast<std::size_t>(streamer.GetMetrics().chunkCount) };
+        ok = occupancy.GetBlockBytes()
+            <= (maxResidentChunks + 1) * chunkWords * sizeof(std::uint64_t) + chunkCount * sizeof(std::uint32_t) && ok;
+    }
+
+    // a chunk with an unknown tile value stays all walls, its neighbours page in
+    {
+        auto corrupt{ tiles };
+        corrupt[calc_map_index(40, 40, size)] = 7;
+
+        const StreamConfig config{ true, 32, 40, 64 };
+        OccupancyGrid occupancy;
+        ChunkStreamer streamer{ corrupt.data(), size, size, config, occupancy };
+        streamer.Update(36, 36, occupancy);
+        streamer.Flush(occupancy);
+
+        ok = streamer.IsResident(36, 36) && occupancy.IsWall(36, 36) && !occupancy.IsWall(1, 1) && ok;
+    }
+
+    std::printf("chunk_streamer: %s\n", ok ? "ok" : "FAILED");
+
+    return ok;
+}
+
+/**
+ * @brief Compares the casts of a player that keeps and shifts its rays with fresh casts at the same pose.
+ */
+static bool check_ray_cache()
+{
+    constexpr auto size{ 64 };
+    const auto config{ create_config(1024, 768, 256, 60, size / 2 - 1) };
+    JobSystem jobs{ config.threads.workers, config.threads.deterministic };
+    Map map{ config, size, size, create_arena(size, DENSE_SPACING) };
+    Player player{ config, map };
+
+    auto mismatches{ 0 };
+    const auto compare{ [&]() {
+        Player reference{ config, map };
+        reference.SetPositionsByScreenXY(player.GetScreenPosition().x, player.GetScreenPosition().y);
+        reference.radians = player.radians;
+        reference.CastRays(jobs);
+
+        for (auto i{ 0 }; i < player.rays.Size(); ++i)
+        {
+            const auto length{ reference.rays.GetLengths()[i] };
+            const auto close{ std::abs(player.rays.GetLengths()[i] - length) <= 1.0e-3f * std::max(length, 1.0f) };
+            const auto angle{ std::abs(player.rays.GetRadians()[i] - reference.rays.GetRadians()[i]) };
+            mismatches += !close || (angle > 1.0e-4f && angle < 6.28f) ? 1 : 0;
+        }
+    } };
+
+    const auto nrOfRays{ config.player.nrOfRays };
+    const auto radPerRay{ config.player.fovRad / static_cast<float>(nrOfRays) };
+    player.radians = static_cast<float>(M_PI);
+    auto ok{ player.CastRays(jobs) && !player.CastRays(jobs) };
+    auto recasts{ 0 };
+    auto keptColumns{ 0 };
+
+    // the turn and the columns the view moves by: whole columns both ways, a fraction of a
+    // column that stays on the same column, a fraction that rounds up and more than the view
+    constexpr std::pair<float, int> turns[]{
+        { 5.0f, 5 }, { -12.0f, -12 }, { 1.0f, 1 }, { 40.0f, 40 }, { -255.0f, -255 },
+        { 200.0f, 200 }, { 0.4f, 0 }, { 0.3f, 1 }, { 300.0f, 300 }, { -3.0f, -3 }
+    };
+    for (const auto& [columns, shift] : turns)
+    {
+        const std::vector<float> before(player.rays.GetLengths().begin(), player.rays.GetLengths().end());
+        player.radians = clamp_radians(player.radians + columns * radPerRay);
+        const auto cast{ player.CastRays(jobs) };
+        ok = cast == (shift != 0) && !player.CastRays(jobs) && ok;
+        recasts += cast ? 1 : 0;
+        compare();
+
+        // the kept columns are the old results, moved sideways
+        if (shift != 0 && std::abs(shift) < nrOfRays)
+        {
+            for (auto i{ std::max(0, -shift) }; i < std::min(nrOfRays, nrOfRays - shift); ++i)
+            {
+                ok = player.rays.GetLengths()[i] == before[i + shift] && ok;
+                ++keptColumns;
+            }
+        }
+    }
+
+    // a turn across 0 recasts everything
+    player.radians = clamp_radians(-2.0f * radPerRay);
+    recasts += player.CastRays(jobs) ? 1 : 0;
+    player.radians = clamp_radians(player.radians + 5.0f * radPerRay);
+    recasts += player.CastRays(jobs) ? 1 : 0;
+    compare();
+
+    // a changed tile or position invalidates the rays
+    map.SetTile(size / 2 + 3, size / 2 - 1, Map::WALL);
+    recasts += player.CastRays(jobs) ? 1 : 0;
+    compare();
+    player.SetPositionsByScreenXY(player.GetScreenPosition().x + 5.0f, player.GetScreenPosition().y);
+    recasts += player.CastRays(jobs) ? 1 : 0;
+    compare();
+
+    ok = ok && recasts == 13 && keptColumns > 0 && mismatches == 0;
+    std::printf("ray_cache: %s (%d kept columns, %d mismatching columns)\n", ok ? "ok" : "FAILED", keptColumns, mismatches);
+
+    return ok;
+}
+
+//-------------------------------------------------
+// Texture sampling
+//-------------------------------------------------
+
+/**
+ * @brief Samples wall columns like the renderer does and returns the nanoseconds per pixel.
+ *
+ * Every screen column reads a different texture column from top to bottom.
+ */
+template <typename F>
+static double bench_texture_columns(const int t_textureSize, F&& t_sample)
+{
+    constexpr auto screenWidth{ 1920 };
+    constexpr auto wallHeight{ 1080 };
+    constexpr auto frames{ 20 };
+
+    std::uint32_t checksum{ 0 };
+    const auto start{ std::chrono::steady_clock::now() };
+    for (auto frame{ 0 }; frame < frames; ++frame)
+    {
+        for (auto x{ 0 }; x < screenWidth; ++x)
+        {
+            // 16.16 fixed-point texture row, as in Map::RenderTexturedWall
+            const auto textureX{ (x * 7) % t_textureSize };
+            const auto step{ (t_textureSize << 16) / wallHeight };
+            auto textureY{ 0 };
+            for (auto y{ 0 }; y < wallHeight; ++y)
+            {
+                checksum += t_sample(textureX, textureY >> 16).n;
+                textureY += step;
+            }
+        }
+    }
+    const auto ns{ std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() };
+
+    // keep the samples alive
+    if (checksum == 42)
+    {
+        std::printf(" ");
+    }
+
+    return ns / (static_cast<double>(screenWidth) * wallHeight * frames);
+}
+
+static void run_texture_columns(const int t_textureSize)
+{
+    olc::Sprite sprite{ t_textureSize, t_textureSize };
+    for (auto y{ 0 }; y < t_textureSize; ++y)
+    {
+        for (auto x{ 0 }; x < t_textureSize; ++x)
+        {
+            sprite.SetPixel(x, y, olc::Pixel(x & 0xff, y & 0xff, (x ^ y) & 0xff));
+        }
+    }
+    const Texture texture{ sprite };
+    const auto* rowMajor{ sprite.GetData() };
+
+    const auto getPixelNs{ bench_texture_columns(t_textureSize, [&](const int t_x, const int t_y) {
+        return sprite.GetPixel(t_x, t_y);
+    }) };
+    const auto rowMajorNs{ bench_texture_columns(t_textureSize, [&](const int t_x, const int t_y) {
+        return rowMajor[t_y * t_textureSize + t_x];
+    }) };
+    const auto columnNs{ bench_texture_columns(t_textureSize, [&](const int t_x, const int t_y) {
+        return texture.GetColumn(t_x)[t_y];
+    }) };
+
+    std::printf("texture_columns %4d^2 GetPixel: %.3f ns/pixel, row-major: %.3f ns/pixel, column-major: %.3f ns/pixel\n",
+        t_textureSize, getPixelNs, rowMajorNs, columnNs);
+}
+
+//-------------------------------------------------
+// Mip selection
+//-------------------------------------------------
+
+/**
+ * @brief Checks the mip levels chosen for walls at known distances.
+ *
+ * Uses the default projection (projection_plane = 48, 768 pixel screen) and a 64x64 texture.
+ *
+ * @return False if a level differs from the expected one.
+ */
+static bool check_mip_selection()
+{
+    const olc::Sprite sprite{ 64, 64 };
+    const Texture texture{ sprite };
+
+    struct Case
+    {
+        float rayLength;
+        int bias;
+        int expectedLevel;
+    };
+
+    constexpr Case cases[]{
+        { 48.0f, 0, 0 },      // 768 px wall, magnified
+        { 576.0f, 0, 0 },     // 64 px, one texel per pixel
+        { 1000.0f, 0, 0 },    // ~37 px, level 1 would have fewer texels than pixels
+        { 1152.0f, 0, 1 },    // 32 px
+        { 2304.0f, 0, 2 },    // 16 px
+        { 4608.0f, 0, 3 },    // 8 px
+        { 576.0f, 1, 1 },     // bias selects a blurrier level
+        { 1.0e6f, 0, 6 },     // clamped to the 1x1 level
+    };
+
+    auto ok{ texture.GetLevelCount() == 7 };
+    for (const auto& c : cases)
+    {
+        const auto wallHeight{ (48.0f / c.rayLength) * 768.0f };
+        const auto level{ Texture::SelectMipLevel(wallHeight, texture.GetHeight(), texture.GetLevelCount(), c.bias) };
+        if (level != c.expectedLevel)
+        {
+            std::printf("mip_selection length %.0f bias %d: level %d, expected %d\n", c.rayLength, c.bias, level, c.expectedLevel);
+            ok = false;
+        }
+    }
+
+    std::printf("mip_selection: %s\n", ok ? "ok" : "FAILED");
+
+    return ok;
+}
+
+/**
+ * @brief Selects the texture columns of hits along three tiles in every mip level of textures
+ *        with power-of-two, odd and other widths.
+ *
+ * @return False if a column is outside its level, or a power-of-two texture doesn't sample
+ *         the column the hit position in the tile names.
+ */
+static bool check_texture_columns()
+{
+    constexpr auto tileSize{ 64.0f };
+
+    auto ok{ true };
+    for (const auto width : { 64, 65, 48, 1 })
+    {
+        const olc::Sprite sprite{ width, 16 };
+        const Texture texture{ sprite };
+
+        for (auto level{ 0 }; level < texture.GetLevelCount(); ++level)
+        {
+            const auto levelWidth{ texture.GetWidth(level) };
+            for (auto hit{ 0.0f }; hit < 3.0f * tileSize; hit += 0.37f)
+            {
+                const auto column{ Texture::SelectColumn(hit, tileSize, levelWidth) };
+                ok = column >= 0 && column < levelWidth && ok;
+                ok = (width != 64 || column == (static_cast<int>(hit) % width) >> level) && ok;
+            }
+
+            // the far edge of a tile
+            ok = Texture::SelectColumn(std::nextafter(tileSize, 0.0f), tileSize, levelWidth) == levelWidth - 1 && ok;
+        }
+    }
+
+    std::printf("texture_columns: %s\n", ok ? "ok" : "FAILED");
+
+    return ok;
+}
+
+//-------------------------------------------------
+// Map files
+//-------------------------------------------------
+
+/**
+ * @brief Writes a binary level, reads it back and checks that damaged copies are rejected.
+ *
+ * @return False if a valid file fails to load or a damaged one loads.
+ */
+static bool check_map_file()
+{
+    constexpr auto size{ 64 };
+    const auto tiles{ create_arena(size, DENSE_SPACING) };
+    const auto path{ (std::filesystem::temp_directory_path() / "raycaster_check.rcmap").string() };
+
+    auto ok{ MapFile::Write(path, size, size, tiles, "name=arena64") };
+
+    MapFile mapFile;
+    ok = ok && mapFile.Open(path) && mapFile.GetWidth() == size && mapFile.GetHeight() == size &&
+        std::memcmp(mapFile.GetTiles(), tiles.data(), tiles.size()) == 0 && mapFile.GetMetadata() == "name=arena64";
+
+    std::string bytes;
+    {
+        std::ifstream file{ path, std::ios::binary };
+        bytes.assign(std::istreambuf_iterator<char>{ file }, {});
+    }
+
+    // each damaged copy must fail to open
+    const auto rejects{ [&](const char* t_name, std::string t_bytes) {
+        {
+            std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+            file << t_bytes;
+        }
+        if (mapFile.Open(path))
+        {
+            std::printf("map_file %s: loaded\n", t_name);
+            return false;
+        }
+        return true;
+    } };
+
+    auto flippedTile{ bytes };
+    flippedTile[flippedTile.size() / 2] ^= 1;
+    ok = rejects("flipped tile", flippedTile) && ok;
+
+    auto newerVersion{ bytes };
+    newerVersion[offsetof(MapFile::MapFileHeader, version)] = MapFile::VERSION + 1;
+    ok = rejects("newer version", newerVersion) && ok;
+
+    auto flippedTable{ bytes };
+    flippedTable[sizeof(MapFile::MapFileHeader) + offsetof(MapFile::MapFileLayer, size)] ^= 1;
+    ok = rejects("flipped layer table", flippedTable) && ok;
+
+    ok = rejects("truncated", bytes.substr(0, bytes.size() / 2)) && ok;
+
+    // a well-formed table with a layer size that wraps around once the padding is added
+    auto hugeLayer{ bytes };
+    {
+        MapFile::MapFileHeader header;
+        std::memcpy(&header, hugeLayer.data(), sizeof(header));
+        MapFile::MapFileLayer layer;
+        std::memcpy(&layer, hugeLayer.data() + header.layerTableOffset, sizeof(layer));
+        layer.size = UINT64_MAX - Map::TILE_PADDING + 1;
+        std::memcpy(hugeLayer.data() + header.layerTableOffset, &layer, sizeof(layer));
+        header.layerTableChecksum = MapFile::Checksum(
+            hugeLayer.data() + header.layerTableOffset, header.layerCount * sizeof(MapFile::MapFileLayer));
+        std::memcpy(hugeLayer.data(), &header, sizeof(header));
+        header.headerChecksum = MapFile::Checksum(hugeLayer.data(), offsetof(MapFile::MapFileHeader, headerChecksum));
+        std::memcpy(hugeLayer.data(), &header, sizeof(header));
+    }
+    ok = rejects("huge layer", hugeLayer) && ok;
+
+    // a streamed level leaves the tiles to the streamer
+    {
+        std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+        file << flippedTile;
+    }
+    ok = mapFile.Open(path, false) && ok;
+
+    std::filesystem::remove(path);
+
+    std::printf("map_file: %s\n", ok ? "ok" : "FAILED");
+
+    return ok;
+}
+
+//-------------------------------------------------
+// Jobs
+//-------------------------------------------------
+
+/**
+ * @brief Runs task graphs with nested ParallelFor() calls and checks the order, the coverage,
+ *        the timing and the trace event of each job and, in deterministic mode, that every chunk
+ *        stays on its worker thread.
+ */
+static bool check_job_system()
+{
+    struct HookCounts
+    {
+        int workers{ 0 };
+        std::atomic<int> jobs{ 0 };
+        std::atomic<int> tasks{ 0 };
+        std::atomic<int> invalid{ 0 };
+    };
+
+    auto ok{ true };
+    std::uint64_t steals{ 0 };
+    for (const auto& [workers, deterministic] : { std::pair{ 1, false }, std::pair{ 4, false }, std::pair{ 3, true } })
+    {
+        JobSystem jobs{ workers, deterministic };
+        HookCounts counts{ workers };
+        jobs.SetTimingHook([](void* t_context, const JobSystem::JobTiming& t_timing) {
+            auto& hookCounts{ *static_cast<HookCounts*>(t_context) };
+            ++hookCounts.jobs;
+            hookCounts.tasks += std::strcmp(t_timing.name, "Cover") != 0 ? 1 : 0;
+            hookCounts.invalid += t_timing.worker < 0 || t_timing.worker >= hookCounts.workers || t_timing.end < t_timing.start ? 1 : 0;
+        }, &counts);
+
+        // a diamond: the two middle tasks split their halves into chunks
+        constexpr auto count{ 10000 };
+        constexpr auto chunkSize{ 100 };
+        std::vector<int> visits(count, 0);
+        std::vector<std::thread::id> owners(count / chunkSize);
+        std::atomic<int> clock{ 0 };
+        std::array<int, 4> stamps{};
+
+        const auto cover{ [&](const int t_offset) {
+            auto chunk{ [&](const int t_begin, const int t_end) {
+                for (auto i{ t_begin }; i < t_end; ++i)
+                {
+                    ++visits[t_offset + i];
+                }
+                owners[(t_offset + t_begin) / chunkSize] = std::this_thread::get_id();
+            } };
+            jobs.ParallelFor(count / 2, chunkSize, chunk, "Cover");
+        } };
+
+        TaskGraph graph;
+        const auto first{ graph.Add("First", [&] { stamps[0] = ++clock; }) };
+        const auto left{ graph.Add("Left", [&] { cover(0); stamps[1] = ++clock; }) };
+        const auto right{ graph.Add("Right", [&] { cover(count / 2); stamps[2] = ++clock; }) };
+        const auto last{ graph.Add("Last", [&] { stamps[3] = ++clock; }) };
+        graph.Precede(first, left);
+        graph.Precede(first, right);
+        graph.Precede(left, last);
+        graph.Precede(right, last);
+
+        constexpr auto runs{ 50 };
+        auto firstOwners{ owners };
+        for (auto run{ 0 }; run < runs; ++run)
+        {
+            clock = 0;
+            jobs.Run(graph);
+            ok = stamps[0] == 1 && stamps[3] == 4 && ok;
+            if (run == 0)
+            {
+                firstOwners = owners;
+            }
+        }
+
+        ok = std::all_of(visits.begin(), visits.end(), [](const int t_visits) { return t_visits == runs; }) && ok;
+        ok = (!deterministic || owners == firstOwners) && ok;
+
+        // every task and, with worker threads, every chunk reports its timing
+        ok = counts.tasks == runs * graph.GetTaskCount() && counts.invalid == 0 && ok;
+        ok = (workers == 1 ? counts.jobs == runs * 6 : counts.jobs == runs * (graph.GetTaskCount() + count / chunkSize)) && ok;
+
+        // the calling thread shares queue 0 with every other thread that isn't a worker
+        const auto caller{ std::this_thread::get_id() };
+        ok = (!deterministic || std::find(owners.begin(), owners.end(), caller) == owners.end()) && ok;
+        steals += jobs.GetStealCount();
+    }
+
+    // every job is a trace event named after its ParallelFor()
+    {
+        const auto path{ (std::filesystem::temp_directory_path() / "raycaster_check_jobs.json").string() };
+        JobSystem jobs{ 4, false };
+        auto chunk{ [](int, int) {} };
+
+        Trace::Begin(path);
+        jobs.ParallelFor(64, 4, chunk, "Traced chunk");
+        Trace::End();
+
+        std::ifstream file{ path };
+        std::string line;
+        auto events{ 0 };
+        while (std::getline(file, line))
+        {
+            events += line.find("\"name\":\"Traced chunk\"") != std::string::npos ? 1 : 0;
+        }
+        ok = events == 16 && ok;
+
+        std::filesystem::remove(path);
+    }
+
+    std::printf("job_system: %s (%llu steals)\n", ok ? "ok" : "FAILED", static_cast<unsigned long long>(steals));
+
+    return ok;
+}
+
+//-------------------------------------------------
+// Simulation
+//-------------------------------------------------
+
+/**
+ * @brief Publishes counters from a writer thread and checks that the reader never sees a torn or older value.
+ */
+static bool check_triple_buffer()
+{
+    struct Value
+    {
+        std::uint64_t first{ 0 };
+        std::array<std::uint64_t, 7> padding{};
+        std::uint64_t last{ 0 };
+    };
+
+    constexpr std::uint64_t count{ 200000 };
+    TripleBuffer<Value> buffer;
+    std::atomic<bool> reading{ false };
+
+    std::thread writer{ [&] {
+        while (!reading.load())
+        {
+        }
+
+        for (std::uint64_t i{ 1 }; i <= count; ++i)
+        {
+            auto& value{ buffer.GetWriteBuffer() };
+            value.first = i;
+            value.last = i;
+            buffer.Publish();
+
+            // lets the reader in between on a single core
+            if (i % 16 == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    } };
+
+    auto ok{ true };
+    auto updates{ 0 };
+    std::uint64_t seen{ 0 };
+    reading.store(true);
+    while (seen < count)
+    {
+        if (buffer.Update())
+        {
+            const auto& value{ buffer.GetReadBuffer() };
+            ok = value.first == value.last && value.first > seen && ok;
+            seen = value.first;
+            ++updates;
+        }
+    }
+    writer.join();
+
+    std::printf("triple_buffer: %s (%d of %llu values seen)\n", ok ? "ok" : "FAILED", updates, static_cast<unsigned long long>(count));
+
+    return ok;
+}
+
+/**
+ * @brief Checks that the inline simulation reaches the same poses at different frame rates and that the thread ticks.
+ */
+static bool check_simulation()
+{
+    constexpr auto size{ 64 };
+    const auto config{ create_config(1024, 768, 256, 60, size / 2 - 1) };
+    const Map map{ config, size, size, create_arena(size, DENSE_SPACING) };
+    std::mutex mapMutex;
+
+    // two seconds: turning and walking, then walking back
+    const auto run{ [&](const int t_framesPerSecond) {
+        Simulation simulation{ config, map, mapMutex };
+        for (auto frame{ 0 }; frame < 2 * t_framesPerSecond; ++frame)
+        {
+            InputState input;
+            input.turnLeft = frame < t_framesPerSecond;
+            input.moveForward = frame < t_framesPerSecond;
+            input.moveBackward = frame >= t_framesPerSecond;
+            simulation.Advance(1.0f / static_cast<float>(t_framesPerSecond), input);
+        }
+
+        return std::tuple{ simulation.GetPose(), simulation.GetTickCount() };
+    } };
+
+    const auto [pose30, ticks30]{ run(30) };
+    const auto [pose60, ticks60]{ run(60) };
+    const auto [pose240, ticks240]{ run(240) };
+    // the ticks are identical, only the leftover time of the frames may differ by a rounding error
+    const auto same{ [](const Simulation::Pose& t_a, const Simulation::Pose& t_b) {
+        return (t_a.screenPosition - t_b.screenPosition).mag() < 1.0e-3f && std::abs(t_a.radians - t_b.radians) < 1.0e-5f;
+    } };
+
+    auto ok{ ticks30 == 240 && ticks60 == 240 && ticks240 == 240 && same(pose30, pose60) && same(pose30, pose240) };
+
+    Simulation simulation{ config, map, mapMutex };
+    simulation.SetInput({ false, true, true, false });
+    simulation.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 100 });
+    simulation.Stop();
+    const auto pose{ simulation.GetPose() };
+    const auto threadTicks{ simulation.GetTickCount() };
+    ok = threadTicks > 0 && pose.radians != 0.0f && ok;
+
+    std::printf("simulation: %s (240 ticks at 30, 60 and 240 fps; %llu threaded ticks in 100 ms)\n",
+        ok ? "ok" : "FAILED", static_cast<unsigned long long>(threadTicks));
+
+    return ok;
+}
+
+//-------------------------------------------------
+// Trace
+//-------------------------------------------------
+
+/**
+ * @brief Ends a trace while threads keep adding nested events faster than they are flushed.
+ *
+ * @return False if the file isn't closed JSON or holds anything else than complete events.
+ */
+static bool check_trace()
+{
+    const auto path{ (std::filesystem::temp_directory_path() / "raycaster_check_trace.json").string() };
+
+    Trace::Begin(path);
+
+    std::atomic<bool> stop{ false };
+    std::atomic<int> started{ 0 };
+    std::vector<std::thread> threads;
+    for (auto i{ 0 }; i < 3; ++i)
+    {
+        threads.emplace_back([&] {
+            ++started;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                FPS_TRACE_SCOPE("Outer");
+                FPS_TRACE_SCOPE("Inner");
+            }
+        });
+    }
+
+    // long enough to fill the buffer, then end while the threads still add events
+    while (started < 3)
+    {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    Trace::End();
+    stop = true;
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::ifstream file{ path };
+    std::string line;
+    auto events{ 0 };
+    auto ok{ std::getline(file, line) && line.starts_with("{\"displayTimeUnit\"") };
+    while (std::getline(file, line) && line != "]}")
+    {
+        ok = line.find("\"ph\":\"X\"") != std::string::npos && line.find("\"dur\":") != std::string::npos && ok;
+        ++events;
+    }
+    ok = line == "]}" && events > 0 && ok;
+
+    std::filesystem::remove(path);
+
+    std::printf("trace: %s (%d complete events)\n", ok ? "ok" : "FAILED", events);
+
+    return ok;
+}
+
+//-------------------------------------------------
+// Results
+//-------------------------------------------------
+
+/**
+ * @brief One measured point of the benchmark matrix.
+ */
+struct BenchResult
+{
+    const char* group;
+    const char* variant;
+    int mapSize;
+    int nrOfRays;
+    int fovDeg;
+    int width;
+    int height;
+    int iterations;
+
+    /**
+     * @brief Nanoseconds per iteration (usually a frame).
+     */
+    double nsPerIteration;
+
+    /**
+     * @brief Nanoseconds per item (a ray or a pixel).
+     */
+    double nsPerItem;
+};
+
+static std::vector<BenchResult> g_results;
+
+static void add_result(const BenchResult& t_result)
+{
+    g_results.push_back(t_result);
+
+    std::printf("%-13s %-9s map %4d rays %4d fov %3d %4dx%-4d %10.1f ns/iter %8.2f ns/item\n",
+        t_result.group, t_result.variant, t_result.mapSize, t_result.nrOfRays, t_result.fovDeg,
+        t_result.width, t_result.height, t_result.nsPerIteration, t_result.nsPerItem);
+}
+
+static bool write_json(const char* t_path)
+{
+    auto* file{ std::fopen(t_path, "w") };
+    if (!file)
+    {
+        std::printf("unable to write %s\n", t_path);
+        return false;
+    }
+
+    std::fprintf(file, "{\n  \"simd\": %s,\n  \"results\": [\n", is_simd_ray_packet_supported() ? "true" : "false");
+    for (std::size_t i{ 0 }; i < g_results.size(); ++i)
+    {
+        const auto& r{ g_results[i] };
+        std::fprintf(file,
+            "    {\"group\": \"%s\", \"variant\": \"%s\", \"map_size\": %d, \"nr_of_rays\": %d, \"fov\": %d, "
+            "\"width\": %d, \"height\": %d, \"iterations\": %d, \"ns_per_iteration\": %.1f, \"ns_per_item\": %.3f}%s\n",
+            r.group, r.variant, r.mapSize, r.nrOfRays, r.fovDeg, r.width, r.height, r.iterations,
+            r.nsPerIteration, r.nsPerItem, i + 1 < g_results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+
+    return std::fclose(file) == 0;
+}
+
+static bool write_csv(const char* t_path)
+{
+    auto* file{ std::fopen(t_path, "w") };
+    if (!file)
+    {
+        std::printf("unable to write %s\n", t_path);
+        return false;
+    }
+
+    std::fprintf(file, "group,variant,map_size,nr_of_rays,fov,width,height,iterations,ns_per_iteration,ns_per_item\n");
+    for (const auto& r : g_results)
+    {
+        std::fprintf(file, "%s,%s,%d,%d,%d,%d,%d,%d,%.1f,%.3f\n",
+            r.group, r.variant, r.mapSize, r.nrOfRays, r.fovDeg, r.width, r.height, r.iterations,
+            r.nsPerIteration, r.nsPerItem);
+    }
+
+    return std::fclose(file) == 0;
+}
+
+//-------------------------------------------------
+// Matrix
+//-------------------------------------------------
+
+struct Resolution
+{
+    int width;
+    int height;
+};
+
+constexpr Resolution RESOLUTIONS[]{ { 640, 480 }, { 1280, 720 }, { 1920, 1080 } };
+constexpr int RAY_COUNTS[]{ 320, 640, 1280, 1920 };
+constexpr int FOVS[]{ 60, 90, 120 };
+constexpr int MAP_SIZES[]{ 8, 64, 256, 1024 };
+
+/**
+ * @brief Runs t_func once per iteration and returns the elapsed nanoseconds per iteration.
+ */
+template <typename F>
+static double time_iterations(const int t_iterations, F&& t_func)
+{
+    const auto start{ std::chrono::steady_clock::now() };
+    for (auto i{ 0 }; i < t_iterations; ++i)
+    {
+        t_func(i);
+    }
+
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / t_iterations;
+}
+
+/**
+ * @brief The player's angle in an iteration; a run turns once around, so every wall side is hit.
+ */
+static float turn_radians(const int t_iteration, const int t_iterations)
+{
+    return clamp_radians(static_cast<float>(t_iteration) * 2.0f * static_cast<float>(M_PI) / t_iterations);
+}
+
+/**
+ * @brief The tile a benchmark player starts on; never a pillar of an arena.
+ */
+static int arena_start_tile(const int t_mapSize)
+{
+    return t_mapSize / 2 - 1;
+}
+
+/**
+ * @brief The reference intersections and the DDA of a player in an arena.
+ */
+static void bench_intersections(const int t_mapSize, const int t_nrOfRays, const int t_fovDeg)
+{
+    const auto config{ create_config(1920, 1080, t_nrOfRays, t_fovDeg, arena_start_tile(t_mapSize)) };
+    const Map map{ config, t_mapSize, t_mapSize, create_arena(t_mapSize, DENSE_SPACING) };
+    const Player player{ config, map };
+    const auto fovRad{ config.player.fovRad };
+    constexpr auto iterations{ 50 };
+
+    Ray ray{ 0.0f, Ray::VERTICAL };
+    auto sink{ 0.0f };
+
+    const auto referenceNs{ time_iterations(iterations, [&](const int t_iteration) {
+        const auto radians{ turn_radians(t_iteration, iterations) - fovRad / 2.0f };
+        for (auto i{ 0 }; i < t_nrOfRays; ++i)
+        {
+            ray.radians = clamp_radians(radians + fovRad * static_cast<float>(i) / static_cast<float>(t_nrOfRays));
+            player.GetVerticalIntersection(ray);
+            sink += ray.length;
+            player.GetHorizontalIntersection(ray);
+            sink += ray.length;
+        }
+    }) };
+    add_result({ "intersections", "reference", t_mapSize, t_nrOfRays, t_fovDeg, 0, 0, iterations, referenceNs, referenceNs / t_nrOfRays });
+
+    const auto ddaNs{ time_iterations(iterations, [&](const int t_iteration) {
+        const auto radians{ turn_radians(t_iteration, iterations) - fovRad / 2.0f };
+        for (auto i{ 0 }; i < t_nrOfRays; ++i)
+        {
+            ray.radians = clamp_radians(radians + fovRad * static_cast<float>(i) / static_cast<float>(t_nrOfRays));
+            player.TraceRay(ray);
+            sink += ray.length;
+        }
+    }) };
+    add_result({ "intersections", "dda", t_mapSize, t_nrOfRays, t_fovDeg, 0, 0, iterations, ddaNs, ddaNs / t_nrOfRays });
+
+    // keep the results alive
+    if (sink == 42.0f)
+    {
+        std::printf(" ");
+    }
+}
+
+/**
+ * @brief The ways bench_trace_grid() crosses empty space.
+ */
+enum class TraceVariant
+{
+    SCALAR, PYRAMID, DISTANCE_FIELD, AVX2, AVX2_PYRAMID
+};
+
+/**
+ * @brief The packet kernel on dense and sparse maps of different sizes; the view rotates
+ *        around a free tile near the center.
+ *
+ * The scalar kernel runs tile by tile, with the occupancy pyramid and with the distance field;
+ * the AVX2 kernel tile by tile and with the occupancy pyramid.
+ */
+static void bench_trace_grid(const int t_mapSize, const int t_fovDeg, const int t_spacing, const TraceVariant t_variant)
+{
+    constexpr auto nrOfRays{ 1920 };
+    constexpr auto iterations{ 50 };
+    constexpr auto tileSize{ 64.0f };
+
+    const auto arenaTiles{ create_arena(t_mapSize, t_spacing) };
+    OccupancyGrid occupancy;
+    occupancy.Build(arenaTiles.data(), t_mapSize, t_mapSize);
+    DistanceField field;
+    auto grid{ occupancy.GetTraceGrid(tileSize) };
+    if (t_variant != TraceVariant::PYRAMID && t_variant != TraceVariant::AVX2_PYRAMID)
+    {
+        grid.pyramid = nullptr;
+    }
+    if (t_variant == TraceVariant::DISTANCE_FIELD)
+    {
+        field.Build(occupancy);
+        grid.distances = field.GetDistances();
+    }
+    const auto simd{ t_variant == TraceVariant::AVX2 || t_variant == TraceVariant::AVX2_PYRAMID };
+
+    const auto originTile{ arena_start_tile(t_mapSize) };
+    const auto origin{ map_to_screen(originTile, originTile, tileSize) };
+
+    // the directions are computed up front, so only the traversal is measured
+    const auto fovRad{ static_cast<float>(t_fovDeg) / 180.0f * static_cast<float>(M_PI) };
+    std::vector<float> dirX(iterations * nrOfRays);
+    std::vector<float> dirY(iterations * nrOfRays);
+    for (auto iteration{ 0 }; iteration < iterations; ++iteration)
+    {
+        const auto radians{ turn_radians(iteration, iterations) - fovRad / 2.0f };
+        for (auto i{ 0 }; i < nrOfRays; ++i)
+        {
+            const auto angle{ radians + fovRad * static_cast<float>(i) / nrOfRays };
+            dirX[iteration * nrOfRays + i] = cosf(angle);
+            dirY[iteration * nrOfRays + i] = sinf(angle);
+        }
+    }
+
+    RayPacket packet{};
+    auto sink{ 0.0f };
+
+    const auto ns{ time_iterations(iterations, [&](const int t_iteration) {
+        for (auto first{ 0 }; first < nrOfRays; first += RayPacket::SIZE)
+        {
+            const auto count{ std::min(RayPacket::SIZE, nrOfRays - first) };
+            std::memcpy(packet.dirX, &dirX[t_iteration * nrOfRays + first], count * sizeof(float));
+            std::memcpy(packet.dirY, &dirY[t_iteration * nrOfRays + first], count * sizeof(float));
+
+            trace_ray_packet(grid, origin.x, origin.y, packet, count, simd);
+            sink += packet.length[0];
+        }
+    }) };
+    add_result({
+        t_spacing == DENSE_SPACING ? "trace_grid" : "trace_grid_sparse",
+        t_variant == TraceVariant::AVX2 ? "avx2"
+            : t_variant == TraceVariant::AVX2_PYRAMID ? "avx2_pyramid"
+            : t_variant == TraceVariant::PYRAMID ? "pyramid"
+            : t_variant == TraceVariant::DISTANCE_FIELD ? "distfield"
+            : "scalar",
+        t_mapSize, nrOfRays, t_fovDeg, 0, 0, iterations, ns, ns / nrOfRays
+    });
+
+    if (sink == 42.0f)
+    {
+        std::printf(" ");
+    }
+}
+
+/**
+ * @brief Player::CastRays on a single thread.
+ */
+static void bench_cast_rays(const int t_mapSize, const Resolution t_resolution, const int t_nrOfRays, const int t_fovDeg)
+{
+    const auto config{ create_config(t_resolution.width, t_resolution.height, t_nrOfRays, t_fovDeg, arena_start_tile(t_mapSize)) };
+    JobSystem jobs{ config.threads.workers, config.threads.deterministic };
+    const Map map{ config, t_mapSize, t_mapSize, create_arena(t_mapSize, DENSE_SPACING) };
+    Player player{ config, map };
+    constexpr auto iterations{ 100 };
+
+    const auto ns{ time_iterations(iterations, [&](const int t_iteration) {
+        player.radians = turn_radians(t_iteration, iterations);
+        player.CastRays(jobs);
+    }) };
+    add_result({ "cast_rays", "pool1", t_mapSize, t_nrOfRays, t_fovDeg, t_resolution.width, t_resolution.height, iterations, ns, ns / t_nrOfRays });
+}
+
+/**
+ * @brief Player::CastRays without a change of the pose and while turning by 8 columns per frame.
+ */
+static void bench_ray_cache(const int t_mapSize, const Resolution t_resolution, const int t_nrOfRays, const int t_fovDeg)
+{
+    const auto config{ create_config(t_resolution.width, t_resolution.height, t_nrOfRays, t_fovDeg, arena_start_tile(t_mapSize)) };
+    JobSystem jobs{ config.threads.workers, config.threads.deterministic };
+    const Map map{ config, t_mapSize, t_mapSize, create_arena(t_mapSize, DENSE_SPACING) };
+    Player player{ config, map };
+    constexpr auto iterations{ 100 };
+
+    player.CastRays(jobs);
+    const auto cachedNs{ time_iterations(iterations, [&](const int) {
+        player.CastRays(jobs);
+    }) };
+    add_result({ "cast_rays", "cached", t_mapSize, t_nrOfRays, t_fovDeg, t_resolution.width, t_resolution.height,
+        iterations, cachedNs, cachedNs / t_nrOfRays });
+
+    const auto turn{ 8.0f * config.player.fovRad / static_cast<float>(t_nrOfRays) };
+    const auto turnNs{ time_iterations(iterations, [&](const int) {
+        player.radians = clamp_radians(player.radians + turn);
+        player.CastRays(jobs);
+    }) };
+    add_result({ "cast_rays", "turn8", t_mapSize, t_nrOfRays, t_fovDeg, t_resolution.width, t_resolution.height,
+        iterations, turnNs, turnNs / t_nrOfRays });
+}
+
+/**
+ * @brief The cost of a ParallelFor() job that does almost nothing.
+ */
+static void bench_job_system(const char* t_variant, const int t_workers)
+{
+    JobSystem jobs{ t_workers, false };
+    constexpr auto count{ 4096 };
+    constexpr auto chunkSize{ 4 };
+    constexpr auto iterations{ 200 };
+
+    std::atomic<int> sink{ 0 };
+    auto chunk{ [&](const int t_begin, const int) {
+        sink.fetch_add(t_begin, std::memory_order_relaxed);
+    } };
+
+    const auto ns{ time_iterations(iterations, [&](const int) {
+        jobs.ParallelFor(count, chunkSize, chunk);
+    }) };
+    add_result({ "jobs", t_variant, 0, count / chunkSize, 0, 0, 0,
+        iterations, ns, ns / (count / chunkSize) });
+}
+
+/**
+ * @brief A HUD of 48 counters, each a label and a live value, drawn into a 1024x768 frame.
+ */
+static void bench_hud_text()
+{
+    const auto font{ create_font() };
+    HudText hud;
+    hud.SetFont(font.get());
+    olc::Sprite target{ 1024, 768 };
+
+    constexpr auto counters{ 48 };
+    constexpr auto iterations{ 1000 };
+    constexpr auto glyphs{ counters * 18 };
+
+    const auto ns{ time_iterations(iterations, [&](const int t_iteration) {
+        for (auto i{ 0 }; i < counters; ++i)
+        {
+            hud.Draw(&target, 500 + i / 24 * 260, 4 + i % 24 * 10, olc::WHITE, HudText::Label{ "Counter: " }, t_iteration * 0.125f + i, " ms");
+        }
+    }) };
+    add_result({ "hud_text", "counters48", 0, 0, 0, target.width, target.height,
+        iterations, ns, ns / glyphs });
+}
+
+/**
+ * @brief Map::Render (the textured wall columns, ceiling and floor) and the minimap into an offscreen sprite.
+ */
+static void bench_render(olc::PixelGameEngine& t_pge, const int t_mapSize, const Resolution t_resolution, const int t_nrOfRays, const int t_fovDeg)
+{
+    const auto config{ create_config(t_resolution.width, t_resolution.height, t_nrOfRays, t_fovDeg, arena_start_tile(t_mapSize)) };
+    JobSystem jobs{ config.threads.workers, config.threads.deterministic };
+    Map map{ config, t_mapSize, t_mapSize, create_arena(t_mapSize, DENSE_SPACING) };
+    Player player{ config, map };
+
+    olc::Sprite target{ t_resolution.width, t_resolution.height };
+    t_pge.SetDrawTarget(&target);
+
+    constexpr auto iterations{ 20 };
+    const auto pixels{ static_cast<double>(t_resolution.width) * t_resolution.height };
+
+    // the rays are cast outside of the measured time
+    auto wallsNs{ 0.0 };
+    for (auto iteration{ 0 }; iteration < iterations; ++iteration)
+    {
+        player.radians = turn_radians(iteration, iterations);
+        player.CastRays(jobs);
+        wallsNs += time_iterations(1, [&](const int) {
+            map.Render(&t_pge, &player, jobs);
+        });
+    }
+    wallsNs /= iterations;
+    add_result({ "render_walls", "textured", t_mapSize, t_nrOfRays, t_fovDeg, t_resolution.width, t_resolution.height,
+        iterations, wallsNs, wallsNs / pixels });
+
+    FrameArena frameArena{ 64 * 1024 };
+    const auto miniMapNs{ time_iterations(iterations, [&](const int) {
+        frameArena.Reset();
+        const auto view{ map.GetMiniMapView(player.GetScreenPosition()) };
+        map.RenderMiniMap(&t_pge, view);
+        player.RenderPlayer(&t_pge, view);
+        player.RenderRays(&t_pge, view, frameArena);
+    }) };
+    add_result({ "minimap", "rays", t_mapSize, t_nrOfRays, t_fovDeg, t_resolution.width, t_resolution.height,
+        iterations, miniMapNs, miniMapNs / t_nrOfRays });
+
+    t_pge.SetDrawTarget(nullptr);
+}
+
+/**
+ * @brief Rebuilds the distance field of a sparse arena, then places and removes single
+ *        pillars in open space and updates it incrementally.
+ */
+static void bench_distance_field(const int t_mapSize)
+{
+    const auto tiles{ create_arena(t_mapSize, SPARSE_SPACING) };
+    OccupancyGrid occupancy;
+    occupancy.Build(tiles.data(), t_mapSize, t_mapSize);
+    DistanceField field;
+    const auto tileCount{ static_cast<double>(t_mapSize) * t_mapSize };
+
+    constexpr auto buildIterations{ 5 };
+    const auto buildNs{ time_iterations(buildIterations, [&](const int) {
+        field.Build(occupancy);
+    }) };
+    add_result({ "distance_field", "build", t_mapSize, 0, 0, 0, 0, buildIterations, buildNs, buildNs / tileCount });
+
+    // an update toggles a tile twice, so the field ends where it started
+    constexpr auto updateIterations{ 100 };
+    const auto updateNs{ time_iterations(updateIterations, [&](const int t_iteration) {
+        const auto x{ 1 + (t_iteration * 37) % (t_mapSize - 2) };
+        const auto y{ 1 + (t_iteration * 53) % (t_mapSize - 2) };
+        const auto wall{ occupancy.IsWall(x, y) };
+        occupancy.SetWall(x, y, !wall);
+        field.Update(occupancy, x, y);
+        occupancy.SetWall(x, y, wall);
+        field.Update(occupancy, x, y);
+    }) };
+    add_result({ "distance_field", "update", t_mapSize, 0, 0, 0, 0, updateIterations, updateNs, updateNs / 2.0 });
+}
+
+/**
+ * @brief Walks across a streamed binary level of t_mapSize x t_mapSize tiles and measures
+ *        the time from requesting a chunk until it is resident, and the game thread's share.
+ */
+static void bench_chunk_streaming(const int t_mapSize)
+{
+    const auto path{ (std::filesystem::temp_directory_path() / "raycaster_bench_stream.map").string() };
+    MapFile::Write(path, t_mapSize, t_mapSize, create_arena(t_mapSize, SPARSE_SPACING));
+
+    MapFile mapFile;
+    if (!mapFile.Open(path))
+    {
+        std::printf("chunk_stream %d^2: FAILED\n", t_mapSize);
+        return;
+    }
+
+    const StreamConfig config{ true, 64, 128, 64 };
+    OccupancyGrid occupancy;
+    ChunkStreamer streamer{ mapFile.GetTiles(), t_mapSize, t_mapSize, config, occupancy };
+
+    // 4 tiles per frame along the diagonal, as a fast player would move
+    constexpr auto iterations{ 200 };
+    const auto ns{ time_iterations(iterations, [&](const int t_iteration) {
+        const auto position{ 8 + (t_iteration * 4) % (t_mapSize - 16) };
+        streamer.Update(position, position, occupancy);
+    }) };
+    streamer.Flush(occupancy);
+
+    const auto& metrics{ streamer.GetMetrics() };
+    add_result({ "chunk_stream", "update", t_mapSize, 0, 0, 0, 0, iterations, ns, ns });
+    const auto avgNs{ metrics.avgPageInMs * 1e6 };
+    const auto maxNs{ metrics.maxPageInMs * 1e6 };
+    add_result({ "chunk_stream", "page_in", t_mapSize, 0, 0, 0, 0, static_cast<int>(metrics.pageIns), avgNs, avgNs });
+    add_result({ "chunk_stream", "page_max", t_mapSize, 0, 0, 0, 0, static_cast<int>(metrics.pageIns), maxNs, maxNs });
+
+    std::filesystem::remove(path);
+}
+
+/**
+ * @brief Loads a text or a binary level of t_mapSize x t_mapSize tiles.
+ */
+static bool bench_map_load(const int t_mapSize, const bool t_binary)
+{
+    const auto config{ create_config(1920, 1080, 1920, 60) };
+    Map map{ config, 8, 8, create_arena(8, DENSE_SPACING) };
+
+    const auto path{ (std::filesystem::temp_directory_path() / "raycaster_bench.map").string() };
+    const auto tiles{ create_arena(t_mapSize, DENSE_SPACING) };
+    if (t_binary)
+    {
+        MapFile::Write(path, t_mapSize, t_mapSize, tiles);
+    }
+    else
+    {
+        std::string text;
+        text.reserve(tiles.size() + t_mapSize);
+        for (auto y{ 0 }; y < t_mapSize; ++y)
+        {
+            for (auto x{ 0 }; x < t_mapSize; ++x)
+            {
+                text += tiles[calc_map_index(x, y, t_mapSize)] == Map::WALL ? '#' : '.';
+            }
+            text += '\n';
+        }
+        std::ofstream file{ path, std::ios::binary };
+        file << text;
+    }
+
+    constexpr auto iterations{ 5 };
+    auto loaded{ true };
+    const auto ns{ time_iterations(iterations, [&](const int) {
+        loaded = map.LoadFromFile(path) && loaded;
+    }) };
+
+    auto ok{ loaded && map.GetWidth() == t_mapSize && map.GetHeight() == t_mapSize };
+    for (auto i{ 0 }; ok && i < t_mapSize * t_mapSize; ++i)
+    {
+        ok = map.IsWallTypeAtMapPosition(i % t_mapSize, i / t_mapSize) == (tiles[i] == Map::WALL);
+    }
+    std::filesystem::remove(path);
+
+    const auto* variant{ t_binary ? "binary" : "text" };
+    if (!ok)
+    {
+        std::printf("map_load %s %d^2: FAILED\n", variant, t_mapSize);
+    }
+    add_result({ "map_load", variant, t_mapSize, 0, 0, 0, 0, iterations, ns, ns / (static_cast<double>(t_mapSize) * t_mapSize) });
+
+    return ok;
+}
+
+/**
+ * @brief Runs every kernel over the matrix of map sizes, ray counts, FOVs and resolutions.
+ */
+static bool run_matrix(olc::PixelGameEngine& t_pge)
+{
+    bench_job_system("inline", 1);
+    bench_job_system("workers4", 4);
+    bench_hud_text();
+
+    auto ok{ true };
+    for (const auto mapSize : { 1024, 4096 })
+    {
+        ok = bench_map_load(mapSize, false) && ok;
+        ok = bench_map_load(mapSize, true) && ok;
+        bench_distance_field(mapSize);
+        bench_chunk_streaming(mapSize);
+    }
+
+    for (const auto fov : FOVS)
+    {
+        for (const auto mapSize : MAP_SIZES)
+        {
+            for (const auto nrOfRays : RAY_COUNTS)
+            {
+                bench_intersections(mapSize, nrOfRays, fov);
+            }
+
+            for (const auto spacing : { DENSE_SPACING, SPARSE_SPACING })
+            {
+                bench_trace_grid(mapSize, fov, spacing, TraceVariant::SCALAR);
+                bench_trace_grid(mapSize, fov, spacing, TraceVariant::PYRAMID);
+                bench_trace_grid(mapSize, fov, spacing, TraceVariant::DISTANCE_FIELD);
+                if (is_simd_ray_packet_supported())
+                {
+                    bench_trace_grid(mapSize, fov, spacing, TraceVariant::AVX2);
+                    bench_trace_grid(mapSize, fov, spacing, TraceVariant::AVX2_PYRAMID);
+                }
+            }
+        }
+
+        for (const auto resolution : RESOLUTIONS)
+        {
+            for (const auto nrOfRays : RAY_COUNTS)
+            {
+                // a ray covers at least one screen column
+                if (nrOfRays > resolution.width)
+                {
+                    continue;
+                }
+
+                for (const auto mapSize : MAP_SIZES)
+                {
+                    bench_cast_rays(mapSize, resolution, nrOfRays, fov);
+                    bench_ray_cache(mapSize, resolution, nrOfRays, fov);
+                }
+
+                // the wall columns and the mini-map window don't depend on the map size
+                bench_render(t_pge, MAP_SIZES[1], resolution, nrOfRays, fov);
+            }
+        }
+    }
+
+    return ok;
+}
+
+//-------------------------------------------------
+// Main
+//-------------------------------------------------
+
+int main(const int t_argc, char* t_argv[])
+{
+    Log::Init();
+
+    // sets up the sprite loader for the wall texture; no window is created
+    olc::PixelGameEngine pge;
+
+    const char* jsonPath{ nullptr };
+    const char* csvPath{ nullptr };
+    auto checksOnly{ false };
+    for (auto i{ 1 }; i < t_argc; ++i)
+    {
+        const std::string arg{ t_argv[i] };
+        if (arg == "--json" && i + 1 < t_argc)
+        {
+            jsonPath = t_argv[++i];
+        }
+        else if (arg == "--csv" && i + 1 < t_argc)
+        {
+            csvPath = t_argv[++i];
+        }
+        else if (arg == "--checks")
+        {
+            checksOnly = true;
+        }
+        else
+        {
+            std::printf("usage: raycaster_bench [--checks] [--json <file>] [--csv <file>]\n");
+            return 2;
+        }
+    }
+
+    const auto levelConfig{ create_config(1920, 1080, 1920, 60) };
+    const Map level{ levelConfig };
+    const auto grid{ level.GetTraceGrid() };
+    constexpr auto nrOfRays{ 1920 };
+
+    // the checks only compare the paths, a single frame is enough
+    const auto frames{ checksOnly ? 1 : 200 };
+
+    // a full turn, so every direction and wall side is covered
+    std::vector<float> dirX(nrOfRays);
+    std::vector<float> dirY(nrOfRays);
+    for (auto i{ 0 }; i < nrOfRays; ++i)
+    {
+        const auto radians{ static_cast<float>(i) * 2.0f * static_cast<float>(M_PI) / nrOfRays };
+        dirX[i] = cosf(radians);
+        dirY[i] = sinf(radians);
+    }
+
+    const auto arenaTiles{ create_arena(64, DENSE_SPACING) };
+    OccupancyGrid arenaOccupancy;
+    arenaOccupancy.Build(arenaTiles.data(), 64, 64);
+    const auto arena{ arenaOccupancy.GetTraceGrid(64.0f) };
+
+    auto ok{ run_ray_packets("map", grid, dirX, dirY, frames) };
+    ok = run_ray_packets("arena64", arena, dirX, dirY, 2) && ok;
+    ok = check_dda_reference() && ok;
+    ok = check_occupancy_grid() && ok;
+    ok = check_jumps() && ok;
+    ok = check_packet_jumps() && ok;
+    ok = check_distance_field() && ok;
+    ok = check_chunk_streamer() && ok;
+    ok = check_ray_cache() && ok;
+    ok = check_cast_rays_allocations() && ok;
+    ok = check_frame_arena() && ok;
+    ok = check_hud_text() && ok;
+    ok = check_job_system() && ok;
+    ok = check_triple_buffer() && ok;
+    ok = check_simulation() && ok;
+    ok = check_trace() && ok;
+
+    ok = check_mip_selection() && ok;
+    ok = check_texture_columns() && ok;
+    ok = check_map_file() && ok;
+
+    if (checksOnly)
+    {
+        return ok ? 0 : 1;
+    }
+
+    run_texture_columns(64);
+    run_texture_columns(1024);
+
+    ok = run_matrix(pge) && ok;
+
+    if (jsonPath)
+    {
+        ok = write_json(jsonPath) && ok;
+    }
+    if (csvPath)
+    {
+        ok = write_csv(csvPath) && ok;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#include <cmath>
+#include "CameraTable.h"
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+bool CameraTable::Update(const float t_fovRad, const int t_nrOfRays)
+{
+    if (t_fovRad == m_fovRad && t_nrOfRays == Size())
+    {
+        return false;
+    }
+
+    m_fovRad = t_fovRad;
+
+    m_angleOffsets.resize(t_nrOfRays);
+    m_dirX.resize(t_nrOfRays);
+    m_dirY.resize(t_nrOfRays);
+
+    const auto startRad{ -t_fovRad / 2.0f };
+    const auto radPerRay{ t_fovRad / static_cast<float>(t_nrOfRays) };
+
+    for (auto i{ 0 }; i < t_nrOfRays; ++i)
+    {
+        const auto offset{ startRad + static_cast<float>(i) * radPerRay };
+        m_angleOffsets[i] = offset;
+        m_dirX[i] = cosf(offset);
+        m_dirY[i] = sinf(offset);
+    }
+
+    return true;
+}
+
+void CameraTable::Rotate(const float t_cos, const float t_sin, float* t_dirX, float* t_dirY, const int t_begin, const int t_end) const
+{
+    for (auto i{ t_begin }; i < t_end; ++i)
+    {
+        t_dirX[i - t_begin] = m_dirX[i] * t_cos - m_dirY[i] * t_sin;
+        t_dirY[i - t_begin] = m_dirX[i] * t_sin + m_dirY[i] * t_cos;
+    }
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+int CameraTable::Size() const
+{
+    return static_cast<int>(m_angleOffsets.size());
+}
+
+std::span<const float> CameraTable::GetAngleOffsets() const
+{
+    return m_angleOffsets;
+}
+
+std::span<const float> CameraTable::GetCosCorrections() const
+{
+    return m_dirX;
+}
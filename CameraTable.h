@@ -0,0 +1,92 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+//-------------------------------------------------
+// CameraTable
+//-------------------------------------------------
+
+/**
+ * @brief Cached per-column angles and trigonometry of the field of view.
+ *
+ * The column offsets only depend on the FOV and the number of rays. They are
+ * computed once and rotated by the player's angle each frame, so casting a
+ * frame needs a single sin/cos pair instead of trigonometry per column.
+ */
+class CameraTable
+{
+public:
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    CameraTable() = default;
+
+    CameraTable(const CameraTable& t_other) = delete;
+    CameraTable(CameraTable&& t_other) noexcept = delete;
+    CameraTable& operator=(const CameraTable& t_other) = delete;
+    CameraTable& operator=(CameraTable&& t_other) noexcept = delete;
+
+    ~CameraTable() noexcept = default;
+
+    //-------------------------------------------------
+    // Logic
+    //-------------------------------------------------
+
+    /**
+     * @brief Rebuilds the table if the FOV or the number of rays changed.
+     *
+     * @param t_fovRad The field of view in radians.
+     * @param t_nrOfRays The number of rays (screen columns).
+     *
+     * @return True if the table was rebuilt, otherwise false.
+     */
+    bool Update(float t_fovRad, int t_nrOfRays);
+
+    /**
+     * @brief Rotates the column directions by the player's angle.
+     *
+     * @param t_cos cos() of the player's angle.
+     * @param t_sin sin() of the player's angle.
+     * @param t_dirX Receives the x-components of the world space ray directions.
+     * @param t_dirY Receives the y-components of the world space ray directions.
+     * @param t_begin The first column.
+     * @param t_end One past the last column.
+     */
+    void Rotate(float t_cos, float t_sin, float* t_dirX, float* t_dirY, int t_begin, int t_end) const;
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    [[nodiscard]] int Size() const;
+
+    /**
+     * @brief The angle of each column relative to the player's view direction.
+     */
+    [[nodiscard]] std::span<const float> GetAngleOffsets() const;
+
+    /**
+     * @brief cos(angle offset) of each column, used to correct the fisheye distortion.
+     */
+    [[nodiscard]] std::span<const float> GetCosCorrections() const;
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    float m_fovRad{ 0.0f };
+
+    std::vector<float> m_angleOffsets;
+
+    /**
+     * @brief The view space direction of each column; x points along the view direction,
+     *        so m_dirX also holds the fisheye correction.
+     */
+    std::vector<float> m_dirX;
+    std::vector<float> m_dirY;
+};
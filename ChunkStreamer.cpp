@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <bit>
+#include "ChunkStreamer.h"
+#include "MapFile.h"
+#include "OccupancyGrid.h"
+#include "Log.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+ChunkStreamer::ChunkStreamer(
+    const std::uint8_t* t_tiles,
+    const int t_width, const int t_height,
+    const StreamConfig& t_config,
+    OccupancyGrid& t_grid
+)
+    : m_tiles{ t_tiles }
+    , m_width{ t_width }
+    , m_height{ t_height }
+    , m_viewDistance{ std::max(0, t_config.viewDistance) }
+    , m_maxResidentChunks{ std::max(1, t_config.maxResidentChunks) }
+{
+    // chunks are whole pyramid squares, so a page-in only touches the squares above it
+    m_chunkSize = static_cast<int>(std::bit_ceil(static_cast<unsigned>(std::max(t_config.chunkSize, OccupancyGrid::BLOCK_SIZE))));
+    m_blocksPerChunk = m_chunkSize >> OccupancyGrid::BLOCK_SHIFT;
+    m_chunksPerRow = (t_width + m_chunkSize - 1) / m_chunkSize;
+    m_chunkRows = (t_height + m_chunkSize - 1) / m_chunkSize;
+
+    m_states.assign(static_cast<std::size_t>(m_chunksPerRow) * m_chunkRows, ChunkState::EVICTED);
+    m_live.reserve(m_maxResidentChunks);
+    m_metrics.chunkCount = static_cast<int>(m_states.size());
+
+    t_grid.Fill(t_width, t_height, m_chunkSize, m_maxResidentChunks);
+
+    m_thread = std::thread{ &ChunkStreamer::Run, this };
+}
+
+ChunkStreamer::~ChunkStreamer() noexcept
+{
+    {
+        std::lock_guard lock{ m_mutex };
+        m_stop = true;
+    }
+    m_wakeCondition.notify_all();
+
+    m_thread.join();
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void ChunkStreamer::Update(const int t_mapX, const int t_mapY, OccupancyGrid& t_grid)
+{
+    Integrate(t_grid);
+
+    // evict what left the view; one chunk of slack, so walking along a chunk border doesn't thrash
+    std::erase_if(m_live, [&](const int t_chunk) {
+        if (Distance(t_chunk, t_mapX, t_mapY) <= m_viewDistance + m_chunkSize)
+        {
+            return false;
+        }
+
+        Evict(t_chunk, t_grid);
+        return true;
+    });
+
+    // the missing chunks in view, nearest first
+    m_missing.clear();
+    const auto firstX{ std::max(t_mapX - m_viewDistance, 0) / m_chunkSize };
+    const auto firstY{ std::max(t_mapY - m_viewDistance, 0) / m_chunkSize };
+    const auto lastX{ std::min(t_mapX + m_viewDistance, m_width - 1) / m_chunkSize };
+    const auto lastY{ std::min(t_mapY + m_viewDistance, m_height - 1) / m_chunkSize };
+    for (auto y{ firstY }; y <= lastY; ++y)
+    {
+        for (auto x{ firstX }; x <= lastX; ++x)
+        {
+            const auto chunk{ y * m_chunksPerRow + x };
+            if (m_states[chunk] == ChunkState::EVICTED && Distance(chunk, t_mapX, t_mapY) <= m_viewDistance)
+            {
+                m_missing.push_back(chunk);
+            }
+        }
+    }
+
+    if (!m_missing.empty())
+    {
+        const auto nearer{ [&](const int t_a, const int t_b) {
+            return Distance(t_a, t_mapX, t_mapY) < Distance(t_b, t_mapX, t_mapY);
+        } };
+        std::sort(m_missing.begin(), m_missing.end(), nearer);
+
+        // make room from the chunks in the slack, farthest first
+        auto room{ m_maxResidentChunks - static_cast<int>(m_live.size()) };
+        if (room < static_cast<int>(m_missing.size()))
+        {
+            std::sort(m_live.begin(), m_live.end(), [&](const int t_a, const int t_b) { return nearer(t_b, t_a); });
+            while (room < static_cast<int>(m_missing.size()) && !m_live.empty() && Distance(m_live.front(), t_mapX, t_mapY) > m_viewDistance)
+            {
+                Evict(m_live.front(), t_grid);
+                m_live.erase(m_live.begin());
+                ++room;
+            }
+        }
+
+        m_missing.resize(std::min(static_cast<int>(m_missing.size()), room));
+        if (!m_missing.empty())
+        {
+            const auto now{ Clock::now() };
+            {
+                std::lock_guard lock{ m_mutex };
+                for (const auto chunk : m_missing)
+                {
+                    m_requests.push_back({ chunk, now });
+                    m_states[chunk] = ChunkState::REQUESTED;
+                    m_live.push_back(chunk);
+                }
+            }
+            m_wakeCondition.notify_one();
+        }
+    }
+
+    CountChunks();
+}
+
+void ChunkStreamer::Flush(OccupancyGrid& t_grid)
+{
+    {
+        std::unique_lock lock{ m_mutex };
+        m_idleCondition.wait(lock, [this] { return m_requests.empty() && !m_busy; });
+    }
+
+    Integrate(t_grid);
+    CountChunks();
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+bool ChunkStreamer::IsResident(const int t_mapX, const int t_mapY) const
+{
+    return m_states[(t_mapY / m_chunkSize) * m_chunksPerRow + t_mapX / m_chunkSize] == ChunkState::RESIDENT;
+}
+
+const ChunkStreamer::Metrics& ChunkStreamer::GetMetrics() const
+{
+    return m_metrics;
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+void ChunkStreamer::Run()
+{
+    while (true)
+    {
+        Request request;
+        {
+            std::unique_lock lock{ m_mutex };
+            m_wakeCondition.wait(lock, [this] { return m_stop || !m_requests.empty(); });
+            if (m_stop)
+            {
+                return;
+            }
+
+            request = m_requests.front();
+            m_requests.pop_front();
+            m_busy = true;
+        }
+
+        // reading the rows faults in the level's pages here instead of on the game thread;
+        // the level was opened without reading its tiles, so they are checked here too
+        const auto blockX{ (request.chunk % m_chunksPerRow) * m_blocksPerChunk };
+        const auto blockY{ (request.chunk / m_chunksPerRow) * m_blocksPerChunk };
+        PageIn pageIn{ request, std::vector<std::uint64_t>(static_cast<std::size_t>(m_blocksPerChunk) * m_blocksPerChunk) };
+        if (AreTilesValid(request.chunk))
+        {
+            OccupancyGrid::EncodeBlocks(m_tiles, m_width, m_height, blockX, blockY, m_blocksPerChunk, m_blocksPerChunk, pageIn.blocks.data());
+        }
+        else
+        {
+            FPS_LOG_ERROR("[ChunkStreamer::Run()] Chunk {} contains unknown tile values, it stays all walls.", request.chunk);
+            std::fill(pageIn.blocks.begin(), pageIn.blocks.end(), ~std::uint64_t{ 0 });
+        }
+
+        {
+            std::lock_guard lock{ m_mutex };
+            m_pageIns.push_back(std::move(pageIn));
+            m_busy = false;
+        }
+        m_idleCondition.notify_all();
+    }
+}
+
+void ChunkStreamer::Integrate(OccupancyGrid& t_grid)
+{
+    {
+        std::lock_guard lock{ m_mutex };
+        std::swap(m_pageIns, m_finished);
+    }
+
+    const auto now{ Clock::now() };
+    for (const auto& pageIn : m_finished)
+    {
+        // evicted while the I/O thread was reading it
+        const auto chunk{ pageIn.request.chunk };
+        if (m_states[chunk] != ChunkState::REQUESTED)
+        {
+            continue;
+        }
+
+        t_grid.SetChunk(chunk, pageIn.blocks.data());
+        m_states[chunk] = ChunkState::RESIDENT;
+
+        const std::chrono::duration<float, std::milli> latency{ now - pageIn.request.time };
+        ++m_metrics.pageIns;
+        m_totalPageInMs += latency.count();
+        m_metrics.lastPageInMs = latency.count();
+        m_metrics.avgPageInMs = static_cast<float>(m_totalPageInMs / static_cast<double>(m_metrics.pageIns));
+        m_metrics.maxPageInMs = std::max(m_metrics.maxPageInMs, latency.count());
+    }
+
+    m_finished.clear();
+}
+
+void ChunkStreamer::Evict(const int t_chunk, OccupancyGrid& t_grid)
+{
+    if (m_states[t_chunk] == ChunkState::RESIDENT)
+    {
+        t_grid.SetChunk(t_chunk, nullptr);
+        ++m_metrics.evictions;
+    }
+    else if (m_states[t_chunk] == ChunkState::REQUESTED)
+    {
+        std::lock_guard lock{ m_mutex };
+        std::erase_if(m_requests, [&](const Request& t_request) { return t_request.chunk == t_chunk; });
+    }
+
+    m_states[t_chunk] = ChunkState::EVICTED;
+}
+
+void ChunkStreamer::CountChunks()
+{
+    m_metrics.residentChunks = static_cast<int>(std::count_if(m_live.begin(), m_live.end(), [this](const int t_chunk) {
+        return m_states[t_chunk] == ChunkState::RESIDENT;
+    }));
+    m_metrics.pendingChunks = static_cast<int>(m_live.size()) - m_metrics.residentChunks;
+}
+
+bool ChunkStreamer::AreTilesValid(const int t_chunk) const
+{
+    const auto left{ (t_chunk % m_chunksPerRow) * m_chunkSize };
+    const auto top{ (t_chunk / m_chunksPerRow) * m_chunkSize };
+    const auto wide{ std::min(m_chunkSize, m_width - left) };
+    const auto bottom{ std::min(top + m_chunkSize, m_height) };
+
+    for (auto y{ top }; y < bottom; ++y)
+    {
+        if (!MapFile::AreTilesValid(m_tiles + static_cast<std::size_t>(y) * m_width + left, wide))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int ChunkStreamer::Distance(const int t_chunk, const int t_mapX, const int t_mapY) const
+{
+    const auto left{ (t_chunk % m_chunksPerRow) * m_chunkSize };
+    const auto top{ (t_chunk / m_chunksPerRow) * m_chunkSize };
+    const auto dx{ std::max({ left - t_mapX, t_mapX - (left + m_chunkSize - 1), 0 }) };
+    const auto dy{ std::max({ top - t_mapY, t_mapY - (top + m_chunkSize - 1), 0 }) };
+
+    return std::max(dx, dy);
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Config.h"
+
+//-------------------------------------------------
+// Forward declarations
+//-------------------------------------------------
+
+class OccupancyGrid;
+
+//-------------------------------------------------
+// ChunkStreamer
+//-------------------------------------------------
+
+/**
+ * @brief Pages square chunks of a large level into an OccupancyGrid around a map position.
+ *
+ * A background I/O thread reads the tiles of the requested chunks, checks their values and
+ * packs them into wall bits; a chunk with unknown values stays all walls. The game thread
+ * copies finished chunks into the grid in Update(). A chunk that isn't resident is all walls
+ * in the grid. Rays hit it at its border and the player can't walk into it, so nothing ever
+ * waits for the I/O thread.
+ *
+ * The grid only holds the blocks of the resident chunks, see OccupancyGrid::Fill(), so the
+ * resident chunk limit bounds its memory.
+ *
+ * The tiles must stay readable and unchanged while the streamer lives.
+ */
+class ChunkStreamer
+{
+public:
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    struct Metrics
+    {
+        int chunkCount{ 0 };
+        int residentChunks{ 0 };
+
+        /**
+         * @brief Chunks requested from the I/O thread but not resident yet.
+         */
+        int pendingChunks{ 0 };
+
+        std::uint64_t pageIns{ 0 };
+        std::uint64_t evictions{ 0 };
+
+        /**
+         * @brief The time from requesting a chunk until it is resident.
+         */
+        float lastPageInMs{ 0.0f };
+        float avgPageInMs{ 0.0f };
+        float maxPageInMs{ 0.0f };
+    };
+
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    /**
+     * @brief Constructs a new ChunkStreamer object, sizes the grid and starts the I/O thread.
+     *
+     * No chunk is resident until the first Update(); until then the grid is all walls.
+     *
+     * @param t_tiles Row-major Map::MapType values, t_width * t_height entries.
+     * @param t_width The width of the map (number of tiles).
+     * @param t_height The height of the map (number of tiles).
+     * @param t_config The chunk size, view distance and resident chunk limit.
+     * @param t_grid The grid to stream into; gets room for the resident chunk limit.
+     */
+    ChunkStreamer(const std::uint8_t* t_tiles, int t_width, int t_height, const StreamConfig& t_config, OccupancyGrid& t_grid);
+
+    ChunkStreamer(const ChunkStreamer& t_other) = delete;
+    ChunkStreamer(ChunkStreamer&& t_other) noexcept = delete;
+    ChunkStreamer& operator=(const ChunkStreamer& t_other) = delete;
+    ChunkStreamer& operator=(ChunkStreamer&& t_other) noexcept = delete;
+
+    ~ChunkStreamer() noexcept;
+
+    //-------------------------------------------------
+    // Logic
+    //-------------------------------------------------
+
+    /**
+     * @brief Copies finished chunks into the grid, evicts chunks out of view and requests the nearest missing ones.
+     *
+     * @param t_mapX The x-coordinate on the map to stream around, usually the player's.
+     * @param t_mapY The y-coordinate on the map to stream around.
+     * @param t_grid The grid to update.
+     */
+    void Update(int t_mapX, int t_mapY, OccupancyGrid& t_grid);
+
+    /**
+     * @brief Waits until the I/O thread has finished all requests and copies the chunks into the grid.
+     *
+     * @param t_grid The grid to update.
+     */
+    void Flush(OccupancyGrid& t_grid);
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    /**
+     * @brief Checks if the chunk containing a map position is resident.
+     */
+    [[nodiscard]] bool IsResident(int t_mapX, int t_mapY) const;
+
+    [[nodiscard]] const Metrics& GetMetrics() const;
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    enum class ChunkState : std::uint8_t
+    {
+        EVICTED, REQUESTED, RESIDENT
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Request
+    {
+        int chunk;
+        Clock::time_point time;
+    };
+
+    struct PageIn
+    {
+        Request request;
+        std::vector<std::uint64_t> blocks;
+    };
+
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    const std::uint8_t* m_tiles{ nullptr };
+    int m_width{ 0 };
+    int m_height{ 0 };
+
+    int m_chunkSize{ 64 };
+    int m_blocksPerChunk{ 8 };
+    int m_chunksPerRow{ 0 };
+    int m_chunkRows{ 0 };
+    int m_viewDistance{ 0 };
+    int m_maxResidentChunks{ 0 };
+
+    /**
+     * @brief The state of every chunk; only touched by the game thread.
+     */
+    std::vector<ChunkState> m_states;
+
+    /**
+     * @brief The chunks that are requested or resident.
+     */
+    std::vector<int> m_live;
+
+    /**
+     * @brief Reused by Update(): the missing chunks in view and the finished page-ins.
+     */
+    std::vector<int> m_missing;
+    std::vector<PageIn> m_finished;
+
+    Metrics m_metrics;
+    double m_totalPageInMs{ 0.0 };
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_idleCondition;
+
+    /**
+     * @brief Shared with the I/O thread, guarded by m_mutex.
+     */
+    std::deque<Request> m_requests;
+    std::vector<PageIn> m_pageIns;
+    bool m_busy{ false };
+    bool m_stop{ false };
+
+    //-------------------------------------------------
+    // Helper
+    //-------------------------------------------------
+
+    /**
+     * @brief The I/O thread: packs the tiles of requested chunks into wall bits.
+     */
+    void Run();
+
+    /**
+     * @brief Copies the finished page-ins into the grid.
+     */
+    void Integrate(OccupancyGrid& t_grid);
+
+    /**
+     * @brief Turns a chunk back into walls, or forgets its request.
+     */
+    void Evict(int t_chunk, OccupancyGrid& t_grid);
+
+    /**
+     * @brief Recounts the resident and the pending chunks.
+     */
+    void CountChunks();
+
+    /**
+     * @brief Checks the tile values of a chunk; runs on the I/O thread.
+     */
+    [[nodiscard]] bool AreTilesValid(int t_chunk) const;
+
+    /**
+     * @brief The Chebyshev distance in tiles from a map position to the nearest tile of a chunk.
+     */
+    [[nodiscard]] int Distance(int t_chunk, int t_mapX, int t_mapY) const;
+};
@@ -0,0 +1,47 @@
+#include "Config.h"
+#include <cmath>
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+Config::Config(const inih::INIReader& t_ini)
+{
+    render.screenWidth = t_ini.Get<int>("window", "width");
+    render.screenHeight = t_ini.Get<int>("window", "height");
+    render.tileSize = t_ini.Get<float>("map", "tile_size");
+    render.projectionPlane = t_ini.Get<float>("map", "projection_plane");
+    render.miniMapScale = t_ini.Get<float>("mini_map", "scale");
+    render.miniMapTiles = t_ini.Get<int>("mini_map", "tiles");
+
+    map.file = t_ini.Get<std::string>("map", "file");
+
+    stream.enabled = t_ini.Get<int>("stream", "enabled") != 0;
+    stream.chunkSize = t_ini.Get<int>("stream", "chunk_size");
+    stream.viewDistance = t_ini.Get<int>("stream", "view_distance");
+    stream.maxResidentChunks = t_ini.Get<int>("stream", "max_resident_chunks");
+
+    player.lineLength = t_ini.Get<float>("player", "line_length");
+    player.fovRad = t_ini.Get<float>("player", "fov") / 180.0f * static_cast<float>(M_PI);
+    player.nrOfRays = t_ini.Get<int>("player", "nr_of_rays");
+    player.simd = t_ini.Get<int>("player", "simd") != 0;
+    player.castMode = t_ini.Get<std::string>("player", "cast_mode") == "distance_field" ? CastMode::DISTANCE_FIELD : CastMode::GRID;
+    player.turnSpeed = t_ini.Get<float>("player", "turn_speed");
+    player.moveSpeed = t_ini.Get<float>("player", "move_speed");
+    player.startX = t_ini.Get<int>("player", "start_x");
+    player.startY = t_ini.Get<int>("player", "start_y");
+
+    simulation.tickRate = t_ini.Get<int>("simulation", "tick_rate");
+
+    texture.mipmapping = t_ini.Get<int>("texture", "mipmapping") != 0;
+    texture.mipBias = t_ini.Get<int>("texture", "mip_bias");
+
+    threads.workers = t_ini.Get<int>("threads", "workers");
+    threads.chunkSize = t_ini.Get<int>("threads", "chunk_size");
+    threads.deterministic = t_ini.Get<int>("threads", "deterministic") != 0;
+
+    trace.enabled = t_ini.Get<int>("trace", "enabled") != 0;
+    trace.file = t_ini.Get<std::string>("trace", "file");
+
+    render.rayLineWidth = render.screenWidth / player.nrOfRays;
+}
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <string>
+#include "ini.h"
+
+//-------------------------------------------------
+// RenderConfig
+//-------------------------------------------------
+
+/**
+ * @brief Render settings, resolved once from the Ini-File.
+ */
+struct RenderConfig
+{
+    /**
+     * @brief The width of the window in pixels.
+     */
+    int screenWidth{ 0 };
+
+    /**
+     * @brief The height of the window in pixels.
+     */
+    int screenHeight{ 0 };
+
+    /**
+     * @brief The size of a map tile in screen units.
+     */
+    float tileSize{ 0.0f };
+
+    /**
+     * @brief The distance to the projection plane, used to scale the wall height.
+     */
+    float projectionPlane{ 0.0f };
+
+    /**
+     * @brief The scaling factor for the mini-map.
+     */
+    float miniMapScale{ 0.0f };
+
+    /**
+     * @brief The number of tiles shown around the player on each axis of the mini-map.
+     */
+    int miniMapTiles{ 16 };
+
+    /**
+     * @brief The width in pixels of the screen column covered by a single ray.
+     */
+    int rayLineWidth{ 0 };
+};
+
+//-------------------------------------------------
+// MapConfig
+//-------------------------------------------------
+
+/**
+ * @brief Level settings, resolved once from the Ini-File.
+ */
+struct MapConfig
+{
+    /**
+     * @brief The level file to load at startup.
+     */
+    std::string file;
+};
+
+//-------------------------------------------------
+// StreamConfig
+//-------------------------------------------------
+
+/**
+ * @brief Chunk streaming settings of binary levels, resolved once from the Ini-File.
+ */
+struct StreamConfig
+{
+    /**
+     * @brief If true, binary levels are paged in chunk by chunk around the player instead of loaded at once.
+     */
+    bool enabled{ false };
+
+    /**
+     * @brief The number of tiles per chunk side; rounded up to a power of two of at least 8.
+     */
+    int chunkSize{ 64 };
+
+    /**
+     * @brief The farthest distance in tiles whose chunks are kept resident.
+     */
+    int viewDistance{ 64 };
+
+    /**
+     * @brief The most chunks resident at once, including those being paged in.
+     *
+     * Bounds the wall-bit blocks of the OccupancyGrid and the mapped tile pages the I/O thread reads.
+     */
+    int maxResidentChunks{ 64 };
+};
+
+//-------------------------------------------------
+// CastMode
+//-------------------------------------------------
+
+/**
+ * @brief How the rays cross empty space.
+ */
+enum class CastMode
+{
+    /**
+     * @brief Jumps over empty squares of the occupancy pyramid, tile by tile next to walls; in SIMD packets or scalar.
+     */
+    GRID,
+
+    /**
+     * @brief Jumps by the distance to the nearest wall stored per tile (see DistanceField); for very sparse levels.
+     */
+    DISTANCE_FIELD
+};
+
+//-------------------------------------------------
+// PlayerConfig
+//-------------------------------------------------
+
+/**
+ * @brief Player settings, resolved once from the Ini-File.
+ */
+struct PlayerConfig
+{
+    /**
+     * @brief The length of the direction line drawn on the mini-map.
+     */
+    float lineLength{ 0.0f };
+
+    /**
+     * @brief The field of view in radians.
+     */
+    float fovRad{ 0.0f };
+
+    /**
+     * @brief The number of rays cast per frame.
+     */
+    int nrOfRays{ 0 };
+
+    /**
+     * @brief If true, neighbouring rays are traced in SIMD packets when the CPU supports it.
+     */
+    bool simd{ true };
+
+    /**
+     * @brief How the rays cross empty space; the distance field is always traced without SIMD.
+     */
+    CastMode castMode{ CastMode::GRID };
+
+    /**
+     * @brief The turn speed in radians per second.
+     */
+    float turnSpeed{ 0.0f };
+
+    /**
+     * @brief The move speed in screen units per second.
+     */
+    float moveSpeed{ 0.0f };
+
+    /**
+     * @brief The x-coordinate of the start tile.
+     */
+    int startX{ 0 };
+
+    /**
+     * @brief The y-coordinate of the start tile.
+     */
+    int startY{ 0 };
+};
+
+//-------------------------------------------------
+// SimulationConfig
+//-------------------------------------------------
+
+/**
+ * @brief Simulation settings, resolved once from the Ini-File.
+ */
+struct SimulationConfig
+{
+    /**
+     * @brief The number of simulation ticks per second, independent of the frame rate.
+     */
+    int tickRate{ 120 };
+};
+
+//-------------------------------------------------
+// TextureConfig
+//-------------------------------------------------
+
+/**
+ * @brief Wall texture settings, resolved once from the Ini-File.
+ */
+struct TextureConfig
+{
+    /**
+     * @brief If true, each wall column samples the mip level that matches its projected height.
+     */
+    bool mipmapping{ true };
+
+    /**
+     * @brief Added to the selected mip level; positive values select blurrier levels.
+     */
+    int mipBias{ 0 };
+};
+
+//-------------------------------------------------
+// ThreadConfig
+//-------------------------------------------------
+
+/**
+ * @brief Job system settings, resolved once from the Ini-File.
+ */
+struct ThreadConfig
+{
+    /**
+     * @brief The number of threads running jobs, including the engine thread; <= 0 uses all
+     *        hardware threads, 1 runs every job inline.
+     */
+    int workers{ 1 };
+
+    /**
+     * @brief The number of screen columns per job.
+     */
+    int chunkSize{ 32 };
+
+    /**
+     * @brief If true, every chunk is always processed by the same worker and no job is stolen.
+     */
+    bool deterministic{ false };
+};
+
+//-------------------------------------------------
+// TraceConfig
+//-------------------------------------------------
+
+/**
+ * @brief Trace-event export settings, resolved once from the Ini-File.
+ */
+struct TraceConfig
+{
+    /**
+     * @brief If true, frame and stage events are written to the trace file.
+     */
+    bool enabled{ false };
+
+    /**
+     * @brief The JSON file to write; open it with chrome://tracing or Perfetto.
+     */
+    std::string file{ "trace.json" };
+};
+
+//-------------------------------------------------
+// Config
+//-------------------------------------------------
+
+/**
+ * @brief A typed snapshot of the Ini-File.
+ *
+ * All values are parsed once at startup, so no Ini access is needed inside a frame.
+ */
+struct Config
+{
+    RenderConfig render;
+    MapConfig map;
+    StreamConfig stream;
+    PlayerConfig player;
+    SimulationConfig simulation;
+    TextureConfig texture;
+    ThreadConfig threads;
+    TraceConfig trace;
+
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    /**
+     * @brief Parses all settings from the given Ini-File.
+     *
+     * @param t_ini The Ini-File to read from.
+     */
+    explicit Config(const inih::INIReader& t_ini);
+};
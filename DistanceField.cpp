@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cstdlib>
+#include "DistanceField.h"
+#include "OccupancyGrid.h"
+
+/**
+ * @brief The distance of a neighbour one tile further away, saturated at MAX_DISTANCE.
+ */
+static std::uint8_t next_distance(const std::uint8_t t_distance)
+{
+    return t_distance < DistanceField::MAX_DISTANCE ? static_cast<std::uint8_t>(t_distance + 1) : t_distance;
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void DistanceField::Build(const OccupancyGrid& t_grid)
+{
+    m_width = t_grid.GetWidth();
+    m_height = t_grid.GetHeight();
+    m_distances.assign(static_cast<std::size_t>(m_width) * m_height, MAX_DISTANCE);
+
+    const auto at{ [&](const int t_x, const int t_y) -> std::uint8_t& {
+        return m_distances[static_cast<std::size_t>(t_y) * m_width + t_x];
+    } };
+
+    // forward: walls, the map border and the neighbours left and above
+    for (auto y{ 0 }; y < m_height; ++y)
+    {
+        for (auto x{ 0 }; x < m_width; ++x)
+        {
+            if (t_grid.IsWall(x, y))
+            {
+                at(x, y) = 0;
+                continue;
+            }
+
+            // the positions outside the map are walls
+            if (x == 0 || y == 0 || x == m_width - 1 || y == m_height - 1)
+            {
+                at(x, y) = 1;
+                continue;
+            }
+
+            auto d{ at(x - 1, y) };
+            d = std::min({ d, at(x - 1, y - 1), at(x, y - 1), at(x + 1, y - 1) });
+            at(x, y) = next_distance(d);
+        }
+    }
+
+    // backward: the neighbours right and below; the border tiles are final already
+    for (auto y{ m_height - 2 }; y > 0; --y)
+    {
+        for (auto x{ m_width - 2 }; x > 0; --x)
+        {
+            const auto d{ std::min({ at(x + 1, y), at(x - 1, y + 1), at(x, y + 1), at(x + 1, y + 1) }) };
+            at(x, y) = std::min(at(x, y), next_distance(d));
+        }
+    }
+}
+
+void DistanceField::Update(const OccupancyGrid& t_grid, const int t_mapX, const int t_mapY)
+{
+    const auto index{ t_mapY * m_width + t_mapX };
+    const auto forEachNeighbour{ [&](const int t_index, auto&& t_function) {
+        const auto x{ t_index % m_width };
+        const auto y{ t_index / m_width };
+        for (auto ny{ std::max(y - 1, 0) }; ny <= std::min(y + 1, m_height - 1); ++ny)
+        {
+            for (auto nx{ std::max(x - 1, 0) }; nx <= std::min(x + 1, m_width - 1); ++nx)
+            {
+                if (nx != x || ny != y)
+                {
+                    t_function(nx, ny, ny * m_width + nx);
+                }
+            }
+        }
+    } };
+
+    m_queue.clear();
+
+    // a new wall only lowers distances
+    if (t_grid.IsWall(t_mapX, t_mapY))
+    {
+        if (m_distances[index] != 0)
+        {
+            m_distances[index] = 0;
+            m_queue.push_back(index);
+            Propagate();
+        }
+
+        return;
+    }
+
+    if (m_distances[index] != 0)
+    {
+        return;
+    }
+
+    // Clear the tiles whose nearest wall was the removed one, i.e. whose distance equals their
+    // distance to it. Each of them has such a neighbour one tile nearer, so walking outwards
+    // finds them all. Saturated tiles stay saturated.
+    m_cleared.clear();
+    m_cleared.push_back(index);
+    m_distances[index] = MAX_DISTANCE;
+    for (std::size_t i{ 0 }; i < m_cleared.size(); ++i)
+    {
+        const auto cleared{ m_cleared[i] };
+        const auto radius{ std::max(std::abs(cleared % m_width - t_mapX), std::abs(cleared / m_width - t_mapY)) };
+        forEachNeighbour(cleared, [&](const int t_x, const int t_y, const int t_index) {
+            const auto neighbourRadius{ std::max(std::abs(t_x - t_mapX), std::abs(t_y - t_mapY)) };
+            if (neighbourRadius > radius && neighbourRadius < MAX_DISTANCE && m_distances[t_index] == neighbourRadius)
+            {
+                m_distances[t_index] = MAX_DISTANCE;
+                m_cleared.push_back(t_index);
+            }
+        });
+    }
+
+    // refill them from the map border and the untouched tiles around them
+    for (const auto cleared : m_cleared)
+    {
+        const auto x{ cleared % m_width };
+        const auto y{ cleared / m_width };
+        if (x == 0 || y == 0 || x == m_width - 1 || y == m_height - 1)
+        {
+            m_distances[cleared] = 1;
+            m_queue.push_back(cleared);
+        }
+
+        forEachNeighbour(cleared, [&](int, int, const int t_index) {
+            if (m_distances[t_index] < MAX_DISTANCE)
+            {
+                m_queue.push_back(t_index);
+            }
+        });
+    }
+
+    Propagate();
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+int DistanceField::GetWidth() const
+{
+    return m_width;
+}
+
+int DistanceField::GetHeight() const
+{
+    return m_height;
+}
+
+const std::uint8_t* DistanceField::GetDistances() const
+{
+    return m_distances.empty() ? nullptr : m_distances.data();
+}
+
+int DistanceField::GetDistance(const int t_mapX, const int t_mapY) const
+{
+    return m_distances[static_cast<std::size_t>(t_mapY) * m_width + t_mapX];
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+void DistanceField::Propagate()
+{
+    // the queue grows while it is walked; a tile is queued again whenever its distance drops
+    for (std::size_t i{ 0 }; i < m_queue.size(); ++i)
+    {
+        const auto index{ m_queue[i] };
+        const auto distance{ next_distance(m_distances[index]) };
+        const auto x{ index % m_width };
+        const auto y{ index / m_width };
+
+        for (auto ny{ std::max(y - 1, 0) }; ny <= std::min(y + 1, m_height - 1); ++ny)
+        {
+            for (auto nx{ std::max(x - 1, 0) }; nx <= std::min(x + 1, m_width - 1); ++nx)
+            {
+                auto& neighbour{ m_distances[ny * m_width + nx] };
+                if (distance < neighbour)
+                {
+                    neighbour = distance;
+                    m_queue.push_back(ny * m_width + nx);
+                }
+            }
+        }
+    }
+
+    m_queue.clear();
+}
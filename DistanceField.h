@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+//-------------------------------------------------
+// Forward declarations
+//-------------------------------------------------
+
+class OccupancyGrid;
+
+//-------------------------------------------------
+// DistanceField
+//-------------------------------------------------
+
+/**
+ * @brief The Chebyshev distance in tiles from every tile to the nearest wall.
+ *
+ * A tile with distance d is the center of a (2d - 1) x (2d - 1) square without walls,
+ * so a ray can leave that square in one jump. Walls are 0 and positions outside the
+ * map count as walls, so every square lies on the map. Distances saturate at
+ * MAX_DISTANCE. The field pays off on large open levels.
+ */
+class DistanceField
+{
+public:
+    //-------------------------------------------------
+    // Constants
+    //-------------------------------------------------
+
+    static constexpr std::uint8_t MAX_DISTANCE{ 255 };
+
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    DistanceField() = default;
+
+    DistanceField(const DistanceField& t_other) = delete;
+    DistanceField(DistanceField&& t_other) noexcept = delete;
+    DistanceField& operator=(const DistanceField& t_other) = delete;
+    DistanceField& operator=(DistanceField&& t_other) noexcept = delete;
+
+    ~DistanceField() noexcept = default;
+
+    //-------------------------------------------------
+    // Logic
+    //-------------------------------------------------
+
+    /**
+     * @brief Computes the field of all tiles in two raster passes.
+     *
+     * @param t_grid The wall bits of the map.
+     */
+    void Build(const OccupancyGrid& t_grid);
+
+    /**
+     * @brief Updates the field after a single tile of the grid changed.
+     *
+     * A new wall lowers the distances around it. A removed wall clears the tiles whose
+     * nearest wall it was and refills them from their neighbours. Only the affected
+     * tiles are visited.
+     *
+     * @param t_grid The wall bits of the map, already containing the change.
+     * @param t_mapX The x-coordinate of the changed tile.
+     * @param t_mapY The y-coordinate of the changed tile.
+     */
+    void Update(const OccupancyGrid& t_grid, int t_mapX, int t_mapY);
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    [[nodiscard]] int GetWidth() const;
+    [[nodiscard]] int GetHeight() const;
+
+    /**
+     * @brief Row-major distances, one byte per tile; null before Build().
+     */
+    [[nodiscard]] const std::uint8_t* GetDistances() const;
+
+    /**
+     * @brief The distance of a tile that is on the map.
+     */
+    [[nodiscard]] int GetDistance(int t_mapX, int t_mapY) const;
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    int m_width{ 0 };
+    int m_height{ 0 };
+
+    std::vector<std::uint8_t> m_distances;
+
+    /**
+     * @brief Tile indices waiting to pass on their distance; kept between updates.
+     */
+    std::vector<int> m_queue;
+
+    /**
+     * @brief The tiles cleared by removing a wall; kept between updates.
+     */
+    std::vector<int> m_cleared;
+
+    //-------------------------------------------------
+    // Helper
+    //-------------------------------------------------
+
+    /**
+     * @brief Lowers the neighbours of the queued tiles until no distance changes.
+     */
+    void Propagate();
+};
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include "FrameArena.h"
+#include "Log.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+FrameArena::FrameArena(const std::size_t t_capacity)
+    : m_buffer{ std::make_unique<std::byte[]>(t_capacity) }
+    , m_capacity{ t_capacity }
+{
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void* FrameArena::Allocate(const std::size_t t_size, const std::size_t t_alignment)
+{
+    const auto base{ reinterpret_cast<std::uintptr_t>(m_buffer.get()) };
+
+    auto offset{ m_offset.load(std::memory_order_relaxed) };
+    while (true)
+    {
+        const auto begin{ ((base + offset + t_alignment - 1) & ~(t_alignment - 1)) - base };
+        if (begin + t_size > m_capacity)
+        {
+            break;
+        }
+
+        if (m_offset.compare_exchange_weak(offset, begin + t_size, std::memory_order_relaxed))
+        {
+            return m_buffer.get() + begin;
+        }
+    }
+
+    m_overflows.fetch_add(1, std::memory_order_relaxed);
+
+    return ::operator new(t_size, std::align_val_t{ t_alignment });
+}
+
+void FrameArena::Deallocate(void* t_ptr, [[maybe_unused]] const std::size_t t_size, const std::size_t t_alignment) noexcept
+{
+    const auto* ptr{ static_cast<std::byte*>(t_ptr) };
+    if (ptr >= m_buffer.get() && ptr < m_buffer.get() + m_capacity)
+    {
+        return;
+    }
+
+    ::operator delete(t_ptr, std::align_val_t{ t_alignment });
+}
+
+void FrameArena::Reset()
+{
+    [[maybe_unused]] const auto used{ m_offset.exchange(0, std::memory_order_relaxed) };
+
+#ifdef FPS_DEBUG_BUILD
+    m_highWaterMark = std::max(m_highWaterMark, used);
+
+    const auto overflows{ m_overflows.load(std::memory_order_relaxed) };
+    if (overflows != m_reportedOverflows)
+    {
+        FPS_LOG_WARN(
+            "[FrameArena::Reset()] {} allocations of the last frame didn't fit into {} bytes and went to the heap.",
+            overflows - m_reportedOverflows, m_capacity
+        );
+        m_reportedOverflows = overflows;
+    }
+#endif
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+std::size_t FrameArena::GetCapacity() const
+{
+    return m_capacity;
+}
+
+std::size_t FrameArena::GetUsed() const
+{
+    return m_offset.load(std::memory_order_relaxed);
+}
+
+std::size_t FrameArena::GetHighWaterMark() const
+{
+    return std::max(m_highWaterMark, GetUsed());
+}
+
+std::size_t FrameArena::GetOverflowCount() const
+{
+    return m_overflows.load(std::memory_order_relaxed);
+}
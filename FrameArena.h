@@ -0,0 +1,191 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------
+// FrameArena
+//-------------------------------------------------
+
+/**
+ * @brief A linear allocator for data that only lives until the end of the current frame.
+ *
+ * Allocating moves an offset forward, freeing does nothing, and Reset() at the start of the
+ * next frame takes back everything at once. The buffer is allocated once, so the transient
+ * containers of a frame never touch the heap. Allocating is thread-safe, which lets the tasks
+ * of the frame graph share the arena. A request that doesn't fit anymore falls back to the
+ * heap; debug builds report these overflows in Reset() so that the capacity can be raised.
+ */
+class FrameArena
+{
+public:
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    /**
+     * @brief Constructs a new FrameArena object.
+     *
+     * @param t_capacity The size of the buffer in bytes.
+     */
+    explicit FrameArena(std::size_t t_capacity);
+
+    FrameArena(const FrameArena& t_other) = delete;
+    FrameArena(FrameArena&& t_other) noexcept = delete;
+    FrameArena& operator=(const FrameArena& t_other) = delete;
+    FrameArena& operator=(FrameArena&& t_other) noexcept = delete;
+
+    ~FrameArena() noexcept = default;
+
+    //-------------------------------------------------
+    // Logic
+    //-------------------------------------------------
+
+    /**
+     * @brief Returns aligned memory that stays valid until the next Reset().
+     *
+     * @param t_size The number of bytes.
+     * @param t_alignment A power of two.
+     *
+     * @return Memory from the buffer, or from the heap if the buffer is full.
+     */
+    [[nodiscard]] void* Allocate(std::size_t t_size, std::size_t t_alignment);
+
+    /**
+     * @brief Frees memory of Allocate(); only heap memory of an overflow is actually freed.
+     */
+    void Deallocate(void* t_ptr, std::size_t t_size, std::size_t t_alignment) noexcept;
+
+    /**
+     * @brief Takes back the whole buffer; everything allocated before must be gone.
+     *
+     * Must only be called while nobody allocates, i.e. between two frames.
+     */
+    void Reset();
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    [[nodiscard]] std::size_t GetCapacity() const;
+
+    /**
+     * @brief The bytes allocated from the buffer since the last Reset().
+     */
+    [[nodiscard]] std::size_t GetUsed() const;
+
+    /**
+     * @brief The most bytes a frame has used so far, including the current one.
+     *
+     * Only debug builds remember past frames; release builds return the bytes of the current one.
+     */
+    [[nodiscard]] std::size_t GetHighWaterMark() const;
+
+    /**
+     * @brief The number of allocations that went to the heap so far.
+     */
+    [[nodiscard]] std::size_t GetOverflowCount() const;
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    std::unique_ptr<std::byte[]> m_buffer;
+    std::size_t m_capacity{ 0 };
+
+    std::atomic<std::size_t> m_offset{ 0 };
+    std::size_t m_highWaterMark{ 0 };
+
+    std::atomic<std::size_t> m_overflows{ 0 };
+
+    /**
+     * @brief The overflows at the last Reset(), so that each frame reports only its own.
+     */
+    std::size_t m_reportedOverflows{ 0 };
+};
+
+//-------------------------------------------------
+// FrameAllocator
+//-------------------------------------------------
+
+/**
+ * @brief An STL allocator that takes its memory from a FrameArena.
+ *
+ * @tparam T The value type.
+ */
+template <typename T>
+class FrameAllocator
+{
+public:
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    using value_type = T;
+
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    explicit FrameAllocator(FrameArena& t_arena) noexcept
+        : m_arena{ &t_arena }
+    {}
+
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>& t_other) noexcept
+        : m_arena{ &t_other.GetArena() }
+    {}
+
+    //-------------------------------------------------
+    // Logic
+    //-------------------------------------------------
+
+    [[nodiscard]] T* allocate(const std::size_t t_count)
+    {
+        return static_cast<T*>(m_arena->Allocate(t_count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* t_ptr, const std::size_t t_count) noexcept
+    {
+        m_arena->Deallocate(t_ptr, t_count * sizeof(T), alignof(T));
+    }
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    [[nodiscard]] FrameArena& GetArena() const noexcept
+    {
+        return *m_arena;
+    }
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U>& t_other) const noexcept
+    {
+        return m_arena == &t_other.GetArena();
+    }
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    FrameArena* m_arena;
+};
+
+//-------------------------------------------------
+// Containers
+//-------------------------------------------------
+
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
@@ -1,4 +1,7 @@
+#include <chrono>
 #include "Game.h"
+#include "Log.h"
+#include "Utils.h"
 
 //-------------------------------------------------
 // Ctors. / Dtor.
@@ -7,6 +10,23 @@
 Game::Game()
 {
     sAppName = "First Person Shooter";
+
+    if (m_config.trace.enabled)
+    {
+        Trace::Begin(m_config.trace.file);
+    }
+
+    // the chunks around the start must be resident before the first frame
+    m_map.UpdateStreaming(m_player.GetMapPosition(), true);
+
+    BuildFrameGraph();
+}
+
+Game::~Game() noexcept
+{
+    // the ticks are traced as well
+    m_simulation.Stop();
+    Trace::End();
 }
 
 //-------------------------------------------------
@@ -15,33 +35,215 @@ Game::Game()
 
 bool Game::OnUserCreate()
 {
+    // the font sheet exists once the engine is constructed
+    m_hud.SetFont(GetFontSprite());
+
+    m_simulation.Start();
+
     return true;
 }
 
-bool Game::OnUserUpdate(const float t_dt)
+bool Game::OnUserUpdate([[maybe_unused]] const float t_dt)
 {
     if (GetKey(olc::Key::ESCAPE).bPressed)
     {
         return false;
     }
 
-    Clear(olc::BLACK);
+    FPS_TRACE_SCOPE("OnUserUpdate");
 
-    m_player.HandleInput(t_dt, this);
-    m_map.Render(this, &m_player);
+    // the previous frame is done with its transient data
+    m_frameArena.Reset();
 
-    const auto screenWidth{ INI.Get<float>("window", "width") };
-    const auto screenHeight{ INI.Get<float>("window", "height") };
-    const auto tileSize{ INI.Get<float>("map", "tile_size") };
-    const auto scale{ INI.Get<float>("mini_map", "scale") };
-
-    const auto xOffset{ screenWidth - Map::MAP_WIDTH * tileSize * scale };
-    const auto yOffset{ screenHeight - Map::MAP_HEIGHT * tileSize * scale };
-    Map::RenderMiniMap(this, xOffset, yOffset ,scale);
-    m_player.RenderPlayer(this, xOffset, yOffset ,scale);
-    m_player.CastRays();
-    m_player.RenderRays(this, xOffset, yOffset ,scale);
-    m_player.RenderDebugInfo(this);
+    // the simulation runs at its own rate, the frame time is only used by the engine
+    m_simulation.SetInput(InputState::FromKeyboard(this));
+    UpdateFrame();
 
     return true;
 }
+
+void Game::RunHeadless(const int t_frames, const InputScript& t_script)
+{
+    m_framebuffer = std::make_unique<olc::Sprite>(m_config.render.screenWidth, m_config.render.screenHeight);
+    SetDrawTarget(m_framebuffer.get());
+
+    FPS_LOG_INFO("[Game::RunHeadless()] Running {} frames at {}x{}.", t_frames, m_framebuffer->width, m_framebuffer->height);
+
+    const auto start{ std::chrono::steady_clock::now() };
+
+    for (auto frame{ 0 }; frame < t_frames; ++frame)
+    {
+        m_frameArena.Reset();
+        m_simulation.Advance(HEADLESS_FRAME_TIME, t_script.GetInput(frame));
+        UpdateFrame();
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - start };
+    const auto msPerFrame{ t_frames > 0 ? elapsed.count() / t_frames : 0.0 };
+
+    FPS_LOG_INFO(
+        "[Game::RunHeadless()] {} frames in {:.1f} ms, {:.3f} ms/frame, {:.1f} fps, {} ticks.",
+        t_frames, elapsed.count(), msPerFrame, msPerFrame > 0.0 ? 1000.0 / msPerFrame : 0.0, m_simulation.GetTickCount()
+    );
+
+    if (const auto* streamer{ m_map.GetStreamer() })
+    {
+        const auto& metrics{ streamer->GetMetrics() };
+        FPS_LOG_INFO(
+            "[Game::RunHeadless()] {} of {} chunks resident, {} page-ins, {} evictions, page-in avg {:.3f} ms, max {:.3f} ms.",
+            metrics.residentChunks, metrics.chunkCount, metrics.pageIns, metrics.evictions, metrics.avgPageInMs, metrics.maxPageInMs
+        );
+    }
+
+#ifdef FPS_DEBUG_BUILD
+    for (auto stage{ 0 }; stage < Profiler::STAGE_COUNT; ++stage)
+    {
+        const auto stats{ m_profiler.GetStats(static_cast<Profiler::Stage>(stage)) };
+        FPS_LOG_INFO(
+            "[Game::RunHeadless()] {:<16} avg {:.3f} ms, p99 {:.3f} ms (last {} frames).",
+            Profiler::STAGE_NAMES[stage], stats.avgMs, stats.p99Ms, m_profiler.GetFrameCount()
+        );
+    }
+
+    FPS_LOG_INFO(
+        "[Game::RunHeadless()] Frame arena: max {} of {} bytes, {} allocations went to the heap.",
+        m_frameArena.GetHighWaterMark(), m_frameArena.GetCapacity(), m_frameArena.GetOverflowCount()
+    );
+#endif
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+const olc::Sprite* Game::GetFramebuffer() const
+{
+    return m_framebuffer.get();
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+void Game::UpdateFrame()
+{
+    FPS_TRACE_SCOPE("Frame");
+
+    m_jobs.Run(m_frameGraph);
+
+    FPS_PROFILE_END_FRAME(m_profiler);
+}
+
+void Game::BuildFrameGraph()
+{
+    const auto updatePose{ m_frameGraph.Add("UpdatePose", [this] {
+        FPS_PROFILE_SCOPE(m_profiler, Profiler::UPDATE_POSE);
+        const auto pose{ m_simulation.GetPose() };
+        m_player.radians = pose.radians;
+        m_player.SetPositionsByScreenXY(pose.screenPosition.x, pose.screenPosition.y);
+    }) };
+
+    const auto updateStreaming{ m_frameGraph.Add("UpdateStreaming", [this] {
+        // a tick in progress only delays streaming to the next frame
+        m_redraw = false;
+        if (const std::unique_lock lock{ m_mapMutex, std::try_to_lock }; lock)
+        {
+            m_redraw = m_map.UpdateStreaming(m_player.GetMapPosition());
+        }
+    }) };
+
+    const auto castRays{ m_frameGraph.Add("CastRays", [this] {
+        FPS_PROFILE_SCOPE(m_profiler, Profiler::CAST_RAYS);
+
+        // a headless run measures whole frames, so it never keeps the rays of the last one
+        if (m_framebuffer)
+        {
+            m_player.InvalidateRays();
+        }
+
+        // Without new rays the pose and the map are unchanged, so the draw target still holds this
+        // frame. Debug builds redraw anyway, their HUD shows the stage timings of every frame.
+#ifdef FPS_DEBUG_BUILD
+        constexpr auto alwaysRedraw{ true };
+#else
+        constexpr auto alwaysRedraw{ false };
+#endif
+        m_redraw = m_player.CastRays(m_jobs) || m_redraw || alwaysRedraw;
+    }) };
+
+    const auto render{ m_frameGraph.Add("Render", [this] {
+        if (!m_redraw)
+        {
+            return;
+        }
+
+        FPS_PROFILE_SCOPE(m_profiler, Profiler::RENDER_MAP);
+
+        // the column composer writes every pixel of the view, so a clear would be overdraw
+        if (!m_map.CoversView(this))
+        {
+            Clear(olc::BLACK);
+        }
+
+        m_map.Render(this, &m_player, m_jobs);
+    }) };
+
+    const auto renderMiniMap{ m_frameGraph.Add("RenderMiniMap", [this] {
+        if (!m_redraw)
+        {
+            return;
+        }
+
+        FPS_PROFILE_SCOPE(m_profiler, Profiler::RENDER_MINI_MAP);
+        m_miniMapView = m_map.GetMiniMapView(m_player.GetScreenPosition());
+        m_map.RenderMiniMap(this, m_miniMapView);
+        m_player.RenderPlayer(this, m_miniMapView);
+    }) };
+
+    const auto renderRays{ m_frameGraph.Add("RenderRays", [this] {
+        if (!m_redraw)
+        {
+            return;
+        }
+
+        FPS_PROFILE_SCOPE(m_profiler, Profiler::RENDER_RAYS);
+        m_player.RenderRays(this, m_miniMapView, m_frameArena);
+    }) };
+
+    const auto renderDebugInfo{ m_frameGraph.Add("RenderDebugInfo", [this] {
+        // no font sheet without a renderer
+        if (!m_redraw || m_framebuffer)
+        {
+            return;
+        }
+
+        FPS_PROFILE_SCOPE(m_profiler, Profiler::RENDER_DEBUG_INFO);
+        m_player.RenderDebugInfo(this, m_hud, m_profiler);
+
+        auto* target{ GetDrawTarget() };
+        if (const auto* streamer{ m_map.GetStreamer() })
+        {
+            const auto& metrics{ streamer->GetMetrics() };
+            m_hud.Draw(target, 500, 200, olc::WHITE,
+                HudText::Label{ "Chunks: " }, metrics.residentChunks, " / ", metrics.chunkCount,
+                HudText::Label{ ", pending " }, metrics.pendingChunks,
+                HudText::Label{ ", page-in " }, metrics.avgPageInMs, " ms");
+        }
+
+#ifdef FPS_DEBUG_BUILD
+        const auto screenPixels{ static_cast<std::size_t>(GetDrawTargetWidth()) * GetDrawTargetHeight() };
+        m_hud.Draw(target, 500, 44, olc::WHITE, HudText::Label{ "Pixels written: " }, m_map.GetPixelsWritten(), " / ", screenPixels);
+        m_hud.Draw(target, 500, 210, olc::WHITE,
+            HudText::Label{ "Frame arena: " }, m_frameArena.GetUsed(), HudText::Label{ " B, max " }, m_frameArena.GetHighWaterMark(),
+            " / ", m_frameArena.GetCapacity(), HudText::Label{ " B, overflows " }, m_frameArena.GetOverflowCount());
+#endif
+    }) };
+
+    // the rays need the new pose and chunks; every later stage draws over the previous one
+    m_frameGraph.Precede(updatePose, updateStreaming);
+    m_frameGraph.Precede(updateStreaming, castRays);
+    m_frameGraph.Precede(castRays, render);
+    m_frameGraph.Precede(render, renderMiniMap);
+    m_frameGraph.Precede(renderMiniMap, renderRays);
+    m_frameGraph.Precede(renderRays, renderDebugInfo);
+}
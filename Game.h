@@ -1,8 +1,17 @@
 #pragma once
 
+#include <mutex>
 #include "ini.h"
+#include "Config.h"
 #include "Player.h"
 #include "Map.h"
+#include "JobSystem.h"
+#include "FrameArena.h"
+#include "HudText.h"
+#include "Input.h"
+#include "Simulation.h"
+#include "Profiler.h"
+#include "Trace.h"
 
 //-------------------------------------------------
 // Game
@@ -20,12 +29,29 @@ public:
      */
     inline static const inih::INIReader INI{ "./config.ini" };
 
+    /**
+     * @brief The fixed time step of a headless frame in seconds.
+     */
+    static constexpr auto HEADLESS_FRAME_TIME{ 1.0f / 60.0f };
+
+    /**
+     * @brief The bytes of transient data a frame may allocate before falling back to the heap.
+     */
+    static constexpr std::size_t FRAME_ARENA_SIZE{ 64 * 1024 };
+
     //-------------------------------------------------
     // Ctors. / Dtor.
     //-------------------------------------------------
 
     Game();
 
+    Game(const Game& t_other) = delete;
+    Game(Game&& t_other) noexcept = delete;
+    Game& operator=(const Game& t_other) = delete;
+    Game& operator=(Game&& t_other) noexcept = delete;
+
+    ~Game() noexcept override;
+
     //-------------------------------------------------
     // Logic
     //-------------------------------------------------
@@ -33,6 +59,29 @@ public:
     bool OnUserCreate() override;
     bool OnUserUpdate(float t_dt) override;
 
+    /**
+     * @brief Runs the game without a window or renderer.
+     *
+     * The frames are rendered into an in-memory framebuffer with a fixed time step and
+     * scripted input. The simulation ticks run inline, so a run is reproducible. Every frame
+     * casts all rays and draws the whole view, even if the pose didn't change, so the frame
+     * times measure the full work. The text HUD is skipped, because the font sheet only
+     * exists once a renderer was created. Construct() and Start() must not be called.
+     *
+     * @param t_frames The number of frames to run.
+     * @param t_script The input of each frame.
+     */
+    void RunHeadless(int t_frames, const InputScript& t_script);
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    /**
+     * @brief The framebuffer of the last headless run, or nullptr.
+     */
+    [[nodiscard]] const olc::Sprite* GetFramebuffer() const;
+
 protected:
 
 private:
@@ -40,6 +89,75 @@ private:
     // Member
     //-------------------------------------------------
 
-    Player m_player;
-    Map m_map;
+    /**
+     * @brief The config snapshot, parsed once from the Ini-File.
+     */
+    Config m_config{ INI };
+
+    /**
+     * @brief The persistent worker threads for the frame and the jobs it splits into.
+     */
+    JobSystem m_jobs{ m_config.threads.workers, m_config.threads.deterministic };
+
+    Map m_map{ m_config };
+
+    /**
+     * @brief The rendered player; its pose is interpolated from the simulation every frame.
+     */
+    Player m_player{ m_config, m_map };
+
+    /**
+     * @brief Guards m_map against changes while a simulation tick reads it.
+     */
+    std::mutex m_mapMutex;
+
+    /**
+     * @brief Moves the player in fixed ticks; declared after the map, so it stops first.
+     */
+    Simulation m_simulation{ m_config, m_map, m_mapMutex };
+
+    /**
+     * @brief The stage timings of the last frames; only filled in debug builds.
+     */
+    Profiler m_profiler;
+
+    /**
+     * @brief Holds the transient data of the current frame, e.g. the mini-map's hit markers; reset before each frame.
+     */
+    FrameArena m_frameArena{ FRAME_ARENA_SIZE };
+
+    /**
+     * @brief Draws the HUD text; has no font in a headless run.
+     */
+    HudText m_hud;
+
+    /**
+     * @brief The in-memory draw target of a headless run.
+     */
+    std::unique_ptr<olc::Sprite> m_framebuffer;
+
+    /**
+     * @brief The stages of a frame, built once; see BuildFrameGraph().
+     */
+    TaskGraph m_frameGraph;
+
+    /**
+     * @brief Passed between the stages of the current frame: whether anything needs drawing, and where the mini-map goes.
+     */
+    bool m_redraw{ true };
+    Map::MiniMapView m_miniMapView;
+
+    //-------------------------------------------------
+    // Helper
+    //-------------------------------------------------
+
+    /**
+     * @brief Renders one frame of the newest simulation state into the current draw target.
+     */
+    void UpdateFrame();
+
+    /**
+     * @brief Describes a frame as dependent stages: pose, streaming, casting, the 3D view, the mini-map and the HUD.
+     */
+    void BuildFrameGraph();
 };
@@ -0,0 +1,204 @@
+#include "HudText.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+    #define FPS_HUD_TEXT_SSE2
+#endif
+
+/**
+ * @brief Expands a row mask into one all-ones or all-zeros word per pixel, so a row is drawn with plain bit operations.
+ */
+static constexpr auto g_rowLanes{ [] {
+    std::array<std::array<std::uint32_t, HudText::GLYPH_SIZE>, 256> lanes{};
+    for (auto mask{ 0 }; mask < 256; ++mask)
+    {
+        for (auto column{ 0 }; column < HudText::GLYPH_SIZE; ++column)
+        {
+            lanes[mask][column] = (mask >> column & 1) != 0 ? 0xFFFFFFFFu : 0u;
+        }
+    }
+    return lanes;
+}() };
+
+/**
+ * @brief The glyph index of a character; characters outside the font sheet use the glyph of '?'.
+ */
+static int glyph_index(const char t_char)
+{
+    const auto index{ static_cast<unsigned char>(t_char) - HudText::FIRST_GLYPH };
+    if (index < 0 || index >= HudText::GLYPH_COUNT)
+    {
+        return '?' - HudText::FIRST_GLYPH;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Writes the color to the pixels of a row whose bit is set.
+ */
+static void blend_row(olc::Pixel* t_line, const std::uint8_t t_mask, const olc::Pixel t_color)
+{
+    const auto& lanes{ g_rowLanes[t_mask] };
+#ifdef FPS_HUD_TEXT_SSE2
+    const auto color{ _mm_set1_epi32(static_cast<int>(t_color.n)) };
+    for (auto column{ 0 }; column < HudText::GLYPH_SIZE; column += 4)
+    {
+        auto* dst{ reinterpret_cast<__m128i*>(t_line + column) };
+        const auto lane{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes.data() + column)) };
+        _mm_storeu_si128(dst, _mm_or_si128(_mm_andnot_si128(lane, _mm_loadu_si128(dst)), _mm_and_si128(lane, color)));
+    }
+#else
+    for (auto column{ 0 }; column < HudText::GLYPH_SIZE; ++column)
+    {
+        t_line[column].n = (t_line[column].n & ~lanes[column]) | (t_color.n & lanes[column]);
+    }
+#endif
+}
+
+/**
+ * @brief Draws the glyphs of a run of characters, i.e. t_glyph(0) to t_glyph(t_count - 1).
+ *
+ * A run that is completely inside the target is drawn row by row without any checks;
+ * otherwise every pixel is clipped.
+ *
+ * @return The x-coordinate after the last glyph.
+ */
+template <typename F>
+static int draw_glyphs(olc::Sprite* t_target, const int t_x, const int t_y, const int t_count, F&& t_glyph, const olc::Pixel t_color)
+{
+    constexpr auto size{ HudText::GLYPH_SIZE };
+    const auto width{ t_count * size };
+    auto* pixels{ t_target->GetData() };
+
+    if (t_x >= 0 && t_y >= 0 && t_x + width <= t_target->width && t_y + size <= t_target->height)
+    {
+        for (auto row{ 0 }; row < size; ++row)
+        {
+            auto* line{ pixels + (t_y + row) * t_target->width + t_x };
+            for (auto i{ 0 }; i < t_count; ++i)
+            {
+                if (const auto mask{ t_glyph(i)[row] }; mask != 0)
+                {
+                    blend_row(line + i * size, mask, t_color);
+                }
+            }
+        }
+
+        return t_x + width;
+    }
+
+    for (auto i{ 0 }; i < t_count; ++i)
+    {
+        const auto& glyph{ t_glyph(i) };
+        for (auto row{ 0 }; row < size; ++row)
+        {
+            for (auto column{ 0 }; column < size; ++column)
+            {
+                const auto x{ t_x + i * size + column };
+                const auto y{ t_y + row };
+                if ((glyph[row] >> column & 1) != 0 && x >= 0 && y >= 0 && x < t_target->width && y < t_target->height)
+                {
+                    pixels[y * t_target->width + x] = t_color;
+                }
+            }
+        }
+    }
+
+    return t_x + width;
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+int HudText::DrawLabel(olc::Sprite* t_target, const int t_x, const int t_y, const Label t_label, const olc::Pixel t_color)
+{
+    if (!m_hasFont)
+    {
+        return t_x + static_cast<int>(t_label.GetText().size()) * GLYPH_SIZE;
+    }
+
+    const auto it{ m_labels.find(t_label.GetKey()) };
+    const auto& label{ it != m_labels.end() ? it->second : AddLabel(t_label) };
+
+    const auto* masks{ m_labelMasks.data() + label.firstGlyph };
+
+    return draw_glyphs(t_target, t_x, t_y, label.glyphCount, [masks](const int t_i) -> const GlyphMasks& { return masks[t_i]; }, t_color);
+}
+
+int HudText::DrawText(olc::Sprite* t_target, const int t_x, const int t_y, const std::string_view t_text, const olc::Pixel t_color) const
+{
+    if (!m_hasFont)
+    {
+        return t_x + static_cast<int>(t_text.size()) * GLYPH_SIZE;
+    }
+
+    return draw_glyphs(
+        t_target, t_x, t_y, static_cast<int>(t_text.size()),
+        [&](const int t_i) -> const GlyphMasks& { return m_glyphs[glyph_index(t_text[t_i])]; },
+        t_color
+    );
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+int HudText::GetLabelCount() const
+{
+    return static_cast<int>(m_labels.size());
+}
+
+//-------------------------------------------------
+// Setter
+//-------------------------------------------------
+
+void HudText::SetFont(const olc::Sprite* t_font)
+{
+    m_labels.clear();
+    m_labelMasks.clear();
+    m_glyphs = {};
+    m_hasFont = t_font != nullptr;
+
+    if (!m_hasFont)
+    {
+        return;
+    }
+
+    // 16 glyphs per row of the sheet, a pixel is set if its red channel is
+    for (auto glyph{ 0 }; glyph < GLYPH_COUNT; ++glyph)
+    {
+        const auto sheetX{ (glyph % 16) * GLYPH_SIZE };
+        const auto sheetY{ (glyph / 16) * GLYPH_SIZE };
+        for (auto row{ 0 }; row < GLYPH_SIZE; ++row)
+        {
+            std::uint8_t mask{ 0 };
+            for (auto column{ 0 }; column < GLYPH_SIZE; ++column)
+            {
+                if (t_font->GetPixel(sheetX + column, sheetY + row).r > 0)
+                {
+                    mask |= static_cast<std::uint8_t>(1u << column);
+                }
+            }
+            m_glyphs[glyph][row] = mask;
+        }
+    }
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+const HudText::CachedLabel& HudText::AddLabel(const Label t_label)
+{
+    const auto text{ t_label.GetText() };
+
+    const CachedLabel label{ static_cast<int>(m_labelMasks.size()), static_cast<int>(text.size()) };
+    for (const auto c : text)
+    {
+        m_labelMasks.push_back(m_glyphs[glyph_index(c)]);
+    }
+
+    return m_labels.emplace(t_label.GetKey(), label).first->second;
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "olcPixelGameEngine.h"
+
+//-------------------------------------------------
+// HudText
+//-------------------------------------------------
+
+/**
+ * @brief Draws HUD text with the engine font without allocating.
+ *
+ * The glyphs are read once from the font sprite into one bit mask per row and written
+ * straight into the draw target, eight pixels per row without branching. Numbers are
+ * formatted with std::to_chars into a buffer on the stack. Labels, i.e. string literals
+ * wrapped in a Label, are rasterized into a span of row masks the first time they are drawn,
+ * so drawing them again skips the character lookups. Without a font, e.g. in a headless run,
+ * nothing is drawn, but the positions are advanced as usual.
+ */
+class HudText
+{
+public:
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    /**
+     * @brief A floating point value drawn with a given number of decimal places.
+     */
+    struct Fixed
+    {
+        double value{ 0.0 };
+        int precision{ 2 };
+    };
+
+    /**
+     * @brief A static text whose glyphs are cached by its address.
+     *
+     * Only constant character arrays like string literals can be wrapped: the constructor
+     * reads the text at compile time, so a buffer that may change doesn't compile.
+     */
+    class Label
+    {
+    public:
+        template <std::size_t N>
+        explicit consteval Label(const char (&t_text)[N])
+            : m_text{ t_text }
+            , m_size{ std::char_traits<char>::length(t_text) }
+        {
+        }
+
+        [[nodiscard]] const char* GetKey() const
+        {
+            return m_text;
+        }
+
+        [[nodiscard]] std::string_view GetText() const
+        {
+            return { m_text, m_size };
+        }
+
+    private:
+        const char* m_text;
+        std::size_t m_size;
+    };
+
+    //-------------------------------------------------
+    // Constants
+    //-------------------------------------------------
+
+    /**
+     * @brief The width and height of a glyph of the engine font in pixels.
+     */
+    static constexpr int GLYPH_SIZE{ 8 };
+
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    /**
+     * @brief A glyph as one mask per pixel row; bit i of a row is set if column i of the glyph is.
+     */
+    using GlyphMasks = std::array<std::uint8_t, GLYPH_SIZE>;
+
+    /**
+     * @brief The font sheet holds the printable ASCII characters, starting with the space.
+     */
+    static constexpr int FIRST_GLYPH{ 32 };
+    static constexpr int GLYPH_COUNT{ 96 };
+
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    HudText() = default;
+
+    HudText(const HudText& t_other) = delete;
+    HudText(HudText&& t_other) noexcept = delete;
+    HudText& operator=(const HudText& t_other) = delete;
+    HudText& operator=(HudText&& t_other) noexcept = delete;
+
+    ~HudText() noexcept = default;
+
+    //-------------------------------------------------
+    // Logic
+    //-------------------------------------------------
+
+    /**
+     * @brief Draws a line made of labels, text and numbers, one after another.
+     *
+     * A Label is drawn from its cached glyphs, a const char* or a std::string_view as text,
+     * an arithmetic value as a number with 2 decimal places for floating point types, and a
+     * Fixed with its own number of decimal places.
+     *
+     * @param t_target The sprite to draw into.
+     * @param t_x The x-coordinate of the first character.
+     * @param t_y The y-coordinate of the first character.
+     * @param t_color The text color.
+     * @param t_parts The parts of the line.
+     *
+     * @return The x-coordinate after the last character.
+     */
+    template <typename... Parts>
+    int Draw(olc::Sprite* t_target, int t_x, const int t_y, const olc::Pixel t_color, const Parts&... t_parts)
+    {
+        ((t_x = DrawPart(t_target, t_x, t_y, t_color, t_parts)), ...);
+
+        return t_x;
+    }
+
+    /**
+     * @brief Draws a static label; rasterizes it on first use.
+     *
+     * @return The x-coordinate after the last character.
+     */
+    int DrawLabel(olc::Sprite* t_target, int t_x, int t_y, Label t_label, olc::Pixel t_color);
+
+    /**
+     * @brief Draws text that changes, glyph by glyph.
+     *
+     * @return The x-coordinate after the last character.
+     */
+    int DrawText(olc::Sprite* t_target, int t_x, int t_y, std::string_view t_text, olc::Pixel t_color) const;
+
+    /**
+     * @brief Draws a number.
+     *
+     * @tparam T An arithmetic type.
+     * @param t_precision The decimal places of a floating point value.
+     *
+     * @return The x-coordinate after the last character.
+     */
+    template <typename T>
+    int DrawNumber(olc::Sprite* t_target, const int t_x, const int t_y, const T t_value, const olc::Pixel t_color, const int t_precision = 2) const
+    {
+        static_assert(std::is_arithmetic_v<T>, "Template argument must be an arithmetic type.");
+
+        std::array<char, 64> buffer;
+        std::to_chars_result result;
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), t_value, std::chars_format::fixed, t_precision);
+        }
+        else
+        {
+            result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), t_value);
+        }
+
+        if (result.ec != std::errc{})
+        {
+            return DrawText(t_target, t_x, t_y, "#", t_color);
+        }
+
+        return DrawText(t_target, t_x, t_y, { buffer.data(), static_cast<std::size_t>(result.ptr - buffer.data()) }, t_color);
+    }
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    /**
+     * @brief The number of labels rasterized so far.
+     */
+    [[nodiscard]] int GetLabelCount() const;
+
+    //-------------------------------------------------
+    // Setter
+    //-------------------------------------------------
+
+    /**
+     * @brief Reads the glyphs from a font sheet laid out like the one of the engine and drops the cached labels.
+     *
+     * @param t_font The font sheet of 16 x 6 glyphs, or nullptr for no font.
+     */
+    void SetFont(const olc::Sprite* t_font);
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    /**
+     * @brief The row masks of a label: one GlyphMasks per character in m_labelMasks.
+     */
+    struct CachedLabel
+    {
+        int firstGlyph{ 0 };
+        int glyphCount{ 0 };
+    };
+
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    std::array<GlyphMasks, GLYPH_COUNT> m_glyphs{};
+    bool m_hasFont{ false };
+
+    std::vector<GlyphMasks> m_labelMasks;
+    std::unordered_map<const char*, CachedLabel> m_labels;
+
+    //-------------------------------------------------
+    // Helper
+    //-------------------------------------------------
+
+    int DrawPart(olc::Sprite* t_target, const int t_x, const int t_y, const olc::Pixel t_color, const Label t_label)
+    {
+        return DrawLabel(t_target, t_x, t_y, t_label, t_color);
+    }
+
+    int DrawPart(olc::Sprite* t_target, const int t_x, const int t_y, const olc::Pixel t_color, const char* t_text) const
+    {
+        return DrawText(t_target, t_x, t_y, t_text, t_color);
+    }
+
+    int DrawPart(olc::Sprite* t_target, const int t_x, const int t_y, const olc::Pixel t_color, const std::string_view t_text) const
+    {
+        return DrawText(t_target, t_x, t_y, t_text, t_color);
+    }
+
+    int DrawPart(olc::Sprite* t_target, const int t_x, const int t_y, const olc::Pixel t_color, const Fixed& t_fixed) const
+    {
+        return DrawNumber(t_target, t_x, t_y, t_fixed.value, t_color, t_fixed.precision);
+    }
+
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    int DrawPart(olc::Sprite* t_target, const int t_x, const int t_y, const olc::Pixel t_color, const T t_value) const
+    {
+        return DrawNumber(t_target, t_x, t_y, t_value, t_color);
+    }
+
+    /**
+     * @brief Rasterizes a label into row masks.
+     */
+    const CachedLabel& AddLabel(Label t_label);
+};
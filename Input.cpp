@@ -0,0 +1,111 @@
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "Input.h"
+#include "Log.h"
+
+//-------------------------------------------------
+// InputState
+//-------------------------------------------------
+
+InputState InputState::FromKeyboard(const olc::PixelGameEngine* t_pge)
+{
+    return InputState{
+        t_pge->GetKey(olc::Key::LEFT).bHeld,
+        t_pge->GetKey(olc::Key::RIGHT).bHeld,
+        t_pge->GetKey(olc::Key::UP).bHeld,
+        t_pge->GetKey(olc::Key::DOWN).bHeld
+    };
+}
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+InputScript::InputScript(const std::string& t_path)
+{
+    std::ifstream file{ t_path };
+    if (!file)
+    {
+        FPS_LOG_WARN("[InputScript::InputScript()] Unable to open {}, running without input.", t_path);
+        return;
+    }
+
+    auto endFrame{ 0 };
+    auto lineNr{ 0 };
+    std::string line;
+    while (std::getline(file, line))
+    {
+        ++lineNr;
+
+        std::istringstream tokens{ line };
+        std::string token;
+        if (!(tokens >> token) || token.starts_with('#'))
+        {
+            continue;
+        }
+
+        int frames;
+        try
+        {
+            frames = std::stoi(token);
+        }
+        catch (const std::exception&)
+        {
+            FPS_LOG_WARN("[InputScript::InputScript()] {}:{}: expected a frame count, line skipped.", t_path, lineNr);
+            continue;
+        }
+
+        InputState input;
+        while (tokens >> token)
+        {
+            if (token == "LEFT")
+            {
+                input.turnLeft = true;
+            }
+            else if (token == "RIGHT")
+            {
+                input.turnRight = true;
+            }
+            else if (token == "UP")
+            {
+                input.moveForward = true;
+            }
+            else if (token == "DOWN")
+            {
+                input.moveBackward = true;
+            }
+            else
+            {
+                FPS_LOG_WARN("[InputScript::InputScript()] {}:{}: unknown control {} ignored.", t_path, lineNr, token);
+            }
+        }
+
+        if (frames > 0)
+        {
+            endFrame += frames;
+            m_segments.push_back({ endFrame, input });
+        }
+    }
+
+    FPS_LOG_DEBUG("[InputScript::InputScript()] Loaded {} frames of input from {}.", endFrame, t_path);
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+InputState InputScript::GetInput(const int t_frame) const
+{
+    const auto it{ std::upper_bound(
+        m_segments.begin(), m_segments.end(), t_frame,
+        [](const int t_value, const Segment& t_segment) { return t_value < t_segment.endFrame; }
+    ) };
+
+    return it == m_segments.end() ? InputState{} : it->input;
+}
+
+int InputScript::GetFrameCount() const
+{
+    return m_segments.empty() ? 0 : m_segments.back().endFrame;
+}
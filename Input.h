@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "olcPixelGameEngine.h"
+
+//-------------------------------------------------
+// InputState
+//-------------------------------------------------
+
+/**
+ * @brief The player controls for a single frame, independent of the input source.
+ */
+struct InputState
+{
+    bool turnLeft{ false };
+    bool turnRight{ false };
+    bool moveForward{ false };
+    bool moveBackward{ false };
+
+    /**
+     * @brief Reads the held arrow keys of the PixelGameEngine.
+     *
+     * @param t_pge Pointer to the PixelGameEngine object.
+     *
+     * @return The input state of the current frame.
+     */
+    static InputState FromKeyboard(const olc::PixelGameEngine* t_pge);
+};
+
+//-------------------------------------------------
+// InputScript
+//-------------------------------------------------
+
+/**
+ * @brief A recorded sequence of input states, used to drive headless runs.
+ *
+ * Each line of a script file holds a frame count followed by the held controls,
+ * e.g. "60 UP LEFT". Empty lines and lines starting with '#' are ignored.
+ * Frames past the end of the script have no input.
+ */
+class InputScript
+{
+public:
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    InputScript() = default;
+
+    /**
+     * @brief Loads a script file.
+     *
+     * @param t_path The path to the script file.
+     */
+    explicit InputScript(const std::string& t_path);
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    /**
+     * @brief The input state of a frame.
+     *
+     * @param t_frame The zero-based frame number.
+     *
+     * @return The scripted input state.
+     */
+    [[nodiscard]] InputState GetInput(int t_frame) const;
+
+    /**
+     * @brief The number of scripted frames.
+     */
+    [[nodiscard]] int GetFrameCount() const;
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    struct Segment
+    {
+        int endFrame;
+        InputState input;
+    };
+
+    /**
+     * @brief The scripted segments, ordered by their end frame.
+     */
+    std::vector<Segment> m_segments;
+};
@@ -0,0 +1,343 @@
+#include <algorithm>
+#include "JobSystem.h"
+#include "Trace.h"
+
+/**
+ * @brief The job system and worker index of the calling thread.
+ */
+static thread_local struct
+{
+    const JobSystem* system{ nullptr };
+    int index{ 0 };
+} g_currentWorker;
+
+//-------------------------------------------------
+// TaskGraph
+//-------------------------------------------------
+
+int TaskGraph::Add(const char* t_name, std::function<void()> t_func)
+{
+    m_tasks.push_back({ t_name, std::move(t_func), {}, 0 });
+    m_waiting = std::make_unique<std::atomic<int>[]>(m_tasks.size());
+
+    return static_cast<int>(m_tasks.size()) - 1;
+}
+
+void TaskGraph::Precede(const int t_before, const int t_after)
+{
+    m_tasks[t_before].successors.push_back(t_after);
+    ++m_tasks[t_after].predecessors;
+}
+
+int TaskGraph::GetTaskCount() const
+{
+    return static_cast<int>(m_tasks.size());
+}
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+JobSystem::JobSystem(const int t_workers, const bool t_deterministic)
+    : m_deterministic{ t_deterministic }
+{
+    m_workerCount = t_workers > 0
+        ? t_workers
+        : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    m_workers = std::make_unique<Worker[]>(m_workerCount);
+
+    // worker 0 is the calling thread
+    m_threads.reserve(m_workerCount - 1);
+    for (auto i{ 1 }; i < m_workerCount; ++i)
+    {
+        m_threads.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() noexcept
+{
+    {
+        std::lock_guard lock{ m_sleepMutex };
+        m_stop = true;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void JobSystem::Run(TaskGraph& t_graph)
+{
+    const auto taskCount{ t_graph.GetTaskCount() };
+    if (taskCount == 0)
+    {
+        return;
+    }
+
+    for (auto i{ 0 }; i < taskCount; ++i)
+    {
+        t_graph.m_waiting[i].store(t_graph.m_tasks[i].predecessors, std::memory_order_relaxed);
+    }
+    t_graph.m_pending.store(taskCount, std::memory_order_relaxed);
+
+    // the first task ends up on top of the queue
+    const auto worker{ GetCurrentWorker() };
+    for (auto i{ taskCount - 1 }; i >= 0; --i)
+    {
+        if (t_graph.m_tasks[i].predecessors == 0)
+        {
+            Push(worker, { nullptr, nullptr, i, i + 1, t_graph.m_tasks[i].name, &t_graph, &t_graph.m_pending });
+        }
+    }
+    Wake();
+
+    WaitFor(worker, t_graph.m_pending);
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+int JobSystem::GetWorkerCount() const
+{
+    return m_workerCount;
+}
+
+std::uint64_t JobSystem::GetStealCount() const
+{
+    return m_steals.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------
+// Setter
+//-------------------------------------------------
+
+void JobSystem::SetTimingHook(const TimingHook t_hook, void* t_context)
+{
+    m_timingHook = t_hook;
+    m_timingContext = t_context;
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+void JobSystem::Dispatch(const int t_count, const int t_chunkSize, const JobFunc t_func, void* t_context, const char* t_name)
+{
+    if (t_count <= 0)
+    {
+        return;
+    }
+
+    const auto chunkSize{ std::max(1, t_chunkSize) };
+    const auto nrOfChunks{ (t_count + chunkSize - 1) / chunkSize };
+    const auto worker{ GetCurrentWorker() };
+
+    // nothing to share: run inline without waking anybody
+    if (m_threads.empty() || nrOfChunks == 1)
+    {
+        Execute(worker, { t_func, t_context, 0, t_count, t_name, nullptr, nullptr });
+        return;
+    }
+
+    // the first chunk ends up on top of the own queue, thieves take the last ones;
+    // deterministic chunks skip queue 0, which every thread that isn't a worker shares
+    std::atomic<int> pending{ nrOfChunks };
+    for (auto chunk{ nrOfChunks - 1 }; chunk >= 0; --chunk)
+    {
+        const auto begin{ chunk * chunkSize };
+        Push(
+            m_deterministic ? 1 + chunk % (m_workerCount - 1) : worker,
+            { t_func, t_context, begin, std::min(begin + chunkSize, t_count), t_name, nullptr, &pending }
+        );
+    }
+    Wake();
+
+    WaitFor(worker, pending);
+}
+
+int JobSystem::GetCurrentWorker() const
+{
+    return g_currentWorker.system == this ? g_currentWorker.index : 0;
+}
+
+void JobSystem::Push(const int t_worker, const Job& t_job)
+{
+    auto& worker{ m_workers[t_worker] };
+    {
+        std::lock_guard lock{ worker.mutex };
+        if (worker.tail - worker.head < QUEUE_CAPACITY)
+        {
+            worker.jobs[worker.tail % QUEUE_CAPACITY] = t_job;
+            ++worker.tail;
+            m_queuedJobs.fetch_add(1, std::memory_order_release);
+            return;
+        }
+    }
+
+    Execute(GetCurrentWorker(), t_job);
+}
+
+void JobSystem::Wake()
+{
+    if (m_threads.empty())
+    {
+        return;
+    }
+
+    // taking the mutex orders the wake-up after a worker that is about to sleep checked the queues
+    {
+        std::lock_guard lock{ m_sleepMutex };
+    }
+    m_wakeCondition.notify_all();
+}
+
+bool JobSystem::Pop(const int t_worker, Job& t_job)
+{
+    auto& worker{ m_workers[t_worker] };
+    std::lock_guard lock{ worker.mutex };
+    if (worker.tail == worker.head)
+    {
+        return false;
+    }
+
+    --worker.tail;
+    t_job = worker.jobs[worker.tail % QUEUE_CAPACITY];
+    m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+bool JobSystem::Steal(const int t_worker, Job& t_job)
+{
+    for (auto offset{ 1 }; offset < m_workerCount; ++offset)
+    {
+        auto& victim{ m_workers[(t_worker + offset) % m_workerCount] };
+        std::lock_guard lock{ victim.mutex };
+        if (victim.tail != victim.head)
+        {
+            t_job = victim.jobs[victim.head % QUEUE_CAPACITY];
+            ++victim.head;
+            m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            m_steals.fetch_add(1, std::memory_order_relaxed);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JobSystem::RunNextJob(const int t_worker)
+{
+    Job job;
+    if (Pop(t_worker, job) || (!m_deterministic && Steal(t_worker, job)))
+    {
+        Execute(t_worker, job);
+        return true;
+    }
+
+    return false;
+}
+
+void JobSystem::Execute(const int t_worker, const Job& t_job)
+{
+    const auto start{ m_timingHook ? Clock::now() : Clock::time_point{} };
+
+    {
+        FPS_TRACE_SCOPE(t_job.name);
+
+        if (t_job.graph)
+        {
+            auto& graph{ *t_job.graph };
+            graph.m_tasks[t_job.begin].func();
+        }
+        else
+        {
+            t_job.func(t_job.context, t_job.begin, t_job.end);
+        }
+    }
+
+    // before the job counts as done, so the hook's context outlives every call
+    if (m_timingHook)
+    {
+        m_timingHook(m_timingContext, { t_job.name, t_worker, start, Clock::now() });
+    }
+
+    // the ready successors continue on this worker
+    if (t_job.graph)
+    {
+        auto& graph{ *t_job.graph };
+        auto woken{ false };
+        for (const auto successor : graph.m_tasks[t_job.begin].successors)
+        {
+            if (graph.m_waiting[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                Push(t_worker, { nullptr, nullptr, successor, successor + 1, graph.m_tasks[successor].name, &graph, t_job.pending });
+                woken = true;
+            }
+        }
+
+        if (woken)
+        {
+            Wake();
+        }
+    }
+
+    if (t_job.pending)
+    {
+        t_job.pending->fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+void JobSystem::WaitFor(const int t_worker, const std::atomic<int>& t_pending)
+{
+    while (t_pending.load(std::memory_order_acquire) > 0)
+    {
+        if (!RunNextJob(t_worker))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::WorkerLoop(const int t_worker)
+{
+    g_currentWorker = { this, t_worker };
+
+    while (true)
+    {
+        if (RunNextJob(t_worker))
+        {
+            continue;
+        }
+
+        // a deterministic worker only waits for its own queue
+        std::unique_lock lock{ m_sleepMutex };
+        m_wakeCondition.wait(lock, [&] {
+            if (m_stop)
+            {
+                return true;
+            }
+            if (!m_deterministic)
+            {
+                return m_queuedJobs.load(std::memory_order_acquire) > 0;
+            }
+
+            auto& worker{ m_workers[t_worker] };
+            std::lock_guard workerLock{ worker.mutex };
+            return worker.tail != worker.head;
+        });
+
+        if (m_stop)
+        {
+            return;
+        }
+    }
+}
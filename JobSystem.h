@@ -0,0 +1,332 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//-------------------------------------------------
+// TaskGraph
+//-------------------------------------------------
+
+/**
+ * @brief Tasks and the order between them, e.g. the stages of a frame.
+ *
+ * A graph is built once and run by JobSystem::Run() as often as needed; running it
+ * doesn't allocate. A task starts after all of its predecessors are done, and tasks
+ * without an order between them may run at the same time. A task may split its work
+ * further with JobSystem::ParallelFor().
+ */
+class TaskGraph
+{
+public:
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    TaskGraph() = default;
+
+    TaskGraph(const TaskGraph& t_other) = delete;
+    TaskGraph(TaskGraph&& t_other) noexcept = delete;
+    TaskGraph& operator=(const TaskGraph& t_other) = delete;
+    TaskGraph& operator=(TaskGraph&& t_other) noexcept = delete;
+
+    ~TaskGraph() noexcept = default;
+
+    //-------------------------------------------------
+    // Setter
+    //-------------------------------------------------
+
+    /**
+     * @brief Adds a task.
+     *
+     * @param t_name The name of the task's trace event and timing; must be a string literal.
+     * @param t_func The work of the task.
+     *
+     * @return The id of the task, used by Precede().
+     */
+    int Add(const char* t_name, std::function<void()> t_func);
+
+    /**
+     * @brief Makes a task wait for another one.
+     *
+     * @param t_before The task that runs first.
+     * @param t_after The task that runs after t_before is done.
+     */
+    void Precede(int t_before, int t_after);
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    [[nodiscard]] int GetTaskCount() const;
+
+protected:
+
+private:
+    friend class JobSystem;
+
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    struct Task
+    {
+        const char* name;
+        std::function<void()> func;
+        std::vector<int> successors;
+        int predecessors{ 0 };
+    };
+
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    std::vector<Task> m_tasks;
+
+    /**
+     * @brief The predecessors of each task that aren't done yet in the current run.
+     */
+    std::unique_ptr<std::atomic<int>[]> m_waiting;
+
+    /**
+     * @brief The tasks of the current run that aren't done yet.
+     */
+    std::atomic<int> m_pending{ 0 };
+};
+
+//-------------------------------------------------
+// JobSystem
+//-------------------------------------------------
+
+/**
+ * @brief Persistent worker threads that run jobs from per-worker queues and steal from each other.
+ *
+ * A thread puts new jobs into its own queue and takes the newest one back first, so
+ * split work stays on the warm core. A worker with an empty queue steals the oldest job
+ * of another one, which is the biggest piece left. The calling thread is worker 0 and
+ * helps with the jobs while it waits. With a single worker every job runs inline, without
+ * threads or queues, which suits single-core targets.
+ */
+class JobSystem
+{
+public:
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    using Clock = std::chrono::steady_clock;
+
+    struct JobTiming
+    {
+        const char* name;
+        int worker;
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    /**
+     * @brief Called after every job on the worker that ran it; must be thread-safe.
+     */
+    using TimingHook = void (*)(void* t_context, const JobTiming& t_timing);
+
+    //-------------------------------------------------
+    // Constants
+    //-------------------------------------------------
+
+    /**
+     * @brief The jobs a worker queue can hold; a job that doesn't fit runs right away.
+     */
+    static constexpr int QUEUE_CAPACITY{ 1024 };
+
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    /**
+     * @brief Constructs a new JobSystem object and starts the worker threads.
+     *
+     * @param t_workers The number of threads running jobs, including the calling thread.
+     *                  A value <= 0 uses the number of hardware threads, 1 runs everything inline.
+     * @param t_deterministic If true, chunk i of a ParallelFor() always runs on the worker thread
+     *                        1 + i % (workers - 1) and nothing is stolen; the calling thread
+     *                        only waits for the chunks.
+     */
+    JobSystem(int t_workers, bool t_deterministic);
+
+    JobSystem(const JobSystem& t_other) = delete;
+    JobSystem(JobSystem&& t_other) noexcept = delete;
+    JobSystem& operator=(const JobSystem& t_other) = delete;
+    JobSystem& operator=(JobSystem&& t_other) noexcept = delete;
+
+    ~JobSystem() noexcept;
+
+    //-------------------------------------------------
+    // Logic
+    //-------------------------------------------------
+
+    /**
+     * @brief Calls t_func(begin, end) for all chunks of [0, t_count) and waits until all are done.
+     *
+     * Can be called from inside a job; the waiting thread runs jobs in the meantime.
+     *
+     * @tparam F Callable with the signature void(int t_begin, int t_end).
+     * @param t_count The number of indices.
+     * @param t_chunkSize The number of indices per chunk.
+     * @param t_func The function to call per chunk.
+     * @param t_name The name of the trace event and timing of each chunk; must be a string literal.
+     */
+    template <typename F>
+    void ParallelFor(const int t_count, const int t_chunkSize, F& t_func, const char* t_name = "ParallelFor")
+    {
+        Dispatch(
+            t_count,
+            t_chunkSize,
+            [](void* t_context, const int t_begin, const int t_end) {
+                (*static_cast<F*>(t_context))(t_begin, t_end);
+            },
+            &t_func,
+            t_name
+        );
+    }
+
+    /**
+     * @brief Runs all tasks of a graph in their order and waits until all are done.
+     *
+     * @param t_graph The graph to run; must not run twice at the same time.
+     */
+    void Run(TaskGraph& t_graph);
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    [[nodiscard]] int GetWorkerCount() const;
+
+    /**
+     * @brief The number of jobs taken from another worker's queue so far.
+     */
+    [[nodiscard]] std::uint64_t GetStealCount() const;
+
+    //-------------------------------------------------
+    // Setter
+    //-------------------------------------------------
+
+    /**
+     * @brief Sets or removes (null) the hook that is called with the timing of every job.
+     *
+     * Works in every build, unlike the trace events. Must only be called while no job runs.
+     */
+    void SetTimingHook(TimingHook t_hook, void* t_context);
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    using JobFunc = void (*)(void* t_context, int t_begin, int t_end);
+
+    /**
+     * @brief A chunk of a ParallelFor() or, with a graph, the task with the index begin.
+     */
+    struct Job
+    {
+        JobFunc func{ nullptr };
+        void* context{ nullptr };
+        int begin{ 0 };
+        int end{ 0 };
+        const char* name{ nullptr };
+        TaskGraph* graph{ nullptr };
+
+        /**
+         * @brief Counted down when the job is done; the owner waits for zero.
+         */
+        std::atomic<int>* pending{ nullptr };
+    };
+
+    /**
+     * @brief A ring buffer of jobs: the owner pushes and pops at the tail, thieves take from the head.
+     */
+    struct alignas(64) Worker
+    {
+        std::mutex mutex;
+        std::array<Job, QUEUE_CAPACITY> jobs;
+        std::uint32_t head{ 0 };
+        std::uint32_t tail{ 0 };
+    };
+
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    int m_workerCount{ 1 };
+    bool m_deterministic{ false };
+
+    std::unique_ptr<Worker[]> m_workers;
+    std::vector<std::thread> m_threads;
+
+    /**
+     * @brief The jobs in all queues; the workers sleep while it is zero.
+     */
+    std::atomic<int> m_queuedJobs{ 0 };
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeCondition;
+    bool m_stop{ false };
+
+    std::atomic<std::uint64_t> m_steals{ 0 };
+
+    TimingHook m_timingHook{ nullptr };
+    void* m_timingContext{ nullptr };
+
+    //-------------------------------------------------
+    // Helper
+    //-------------------------------------------------
+
+    void Dispatch(int t_count, int t_chunkSize, JobFunc t_func, void* t_context, const char* t_name);
+
+    /**
+     * @brief The worker index of the calling thread; 0 for threads that aren't workers of this system.
+     */
+    [[nodiscard]] int GetCurrentWorker() const;
+
+    /**
+     * @brief Queues a job on a worker, or runs it right away if the queue is full.
+     */
+    void Push(int t_worker, const Job& t_job);
+
+    /**
+     * @brief Wakes the sleeping workers after jobs were queued.
+     */
+    void Wake();
+
+    [[nodiscard]] bool Pop(int t_worker, Job& t_job);
+    [[nodiscard]] bool Steal(int t_worker, Job& t_job);
+
+    /**
+     * @brief Runs one job of the worker's queue or, if it is empty, a stolen one.
+     *
+     * @return False if there was no job.
+     */
+    bool RunNextJob(int t_worker);
+
+    /**
+     * @brief Runs a job as a trace event, reports its timing and, for a task, queues the successors
+     *        that became ready.
+     */
+    void Execute(int t_worker, const Job& t_job);
+
+    /**
+     * @brief Runs jobs until the counter reaches zero.
+     */
+    void WaitFor(int t_worker, const std::atomic<int>& t_pending);
+
+    void WorkerLoop(int t_worker);
+};
@@ -1,32 +1,199 @@
+#include <atomic>
+#include <fstream>
 #include "Map.h"
-#include "Game.h"
 #include "Player.h"
+#include "JobSystem.h"
 #include "Utils.h"
+#include "Assert.h"
 
 //-------------------------------------------------
 // Ctors. / Dtor.
 //-------------------------------------------------
 
-Map::Map()
+Map::Map(const Config& t_config)
+    : m_config{ t_config }
 {
-    m_texture = std::make_unique<olc::Sprite>("redbrick.png");
+    if (!LoadFromFile(m_config.map.file))
+    {
+        FPS_LOG_WARN("[Map::Map()] Unable to load {}, using an empty room.", m_config.map.file);
+        CreateFallbackRoom();
+    }
+
+    m_texture = std::make_unique<Texture>("redbrick.png");
+}
+
+Map::Map(const Config& t_config, const int t_width, const int t_height, std::vector<std::uint8_t> t_tiles)
+    : m_config{ t_config }
+{
+    SetTiles(t_width, t_height, std::move(t_tiles));
+
+    m_texture = std::make_unique<Texture>("redbrick.png");
 }
 
 //-------------------------------------------------
 // Logic
 //-------------------------------------------------
 
-void Map::RenderMiniMap(olc::PixelGameEngine* t_pge, const float t_screenX, const float t_screenY, const float t_scale)
+bool Map::LoadFromFile(const std::string& t_path)
 {
-    const auto scale{ t_scale * Game::INI.Get<float>("map", "tile_size") };
+    // binary levels are used in place, without copying the tiles
+    if (MapFile::IsMapFile(t_path))
+    {
+        // a streamed level's tiles are first read, and checked, by the streamer's I/O thread
+        auto mapFile{ std::make_unique<MapFile>() };
+        if (!mapFile->Open(t_path, !m_config.stream.enabled))
+        {
+            return false;
+        }
+
+        m_width = mapFile->GetWidth();
+        m_height = mapFile->GetHeight();
+        m_tiles.clear();
+        m_tiles.shrink_to_fit();
+        m_tileData = mapFile->GetTiles();
+        m_streamer.reset();
+        m_mapFile = std::move(mapFile);
+
+        // a streamed level is all walls until its chunks arrive
+        if (m_config.stream.enabled)
+        {
+            m_streamer = std::make_unique<ChunkStreamer>(m_tileData, m_width, m_height, m_config.stream, m_occupancy);
+            ++m_version;
+
+            FPS_LOG_DEBUG("[Map::LoadFromFile()] Streaming {}x{} tiles from {} in {} chunks, {} KiB of wall bits.",
+                m_width, m_height, t_path, m_streamer->GetMetrics().chunkCount, m_occupancy.GetBlockBytes() / 1024);
+
+            return true;
+        }
+
+        BuildTraceData();
+
+        FPS_LOG_DEBUG("[Map::LoadFromFile()] Mapped {}x{} tiles from {}.", m_width, m_height, t_path);
+
+        return true;
+    }
+
+    // read the whole file at once; a 4096x4096 level is 16 MiB of text
+    std::ifstream file{ t_path, std::ios::binary | std::ios::ate };
+    if (!file)
+    {
+        return false;
+    }
+
+    std::string text(static_cast<std::size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    if (!file.read(text.data(), static_cast<std::streamsize>(text.size())))
+    {
+        return false;
+    }
+
+    auto width{ 0 };
+    auto height{ 0 };
+    std::vector<std::uint8_t> tiles;
+    if (!parse_text_map(text, width, height, tiles))
+    {
+        FPS_LOG_ERROR("[Map::LoadFromFile()] {} contains no tiles.", t_path);
+        return false;
+    }
+
+    SetTiles(width, height, std::move(tiles));
+
+    FPS_LOG_DEBUG("[Map::LoadFromFile()] Loaded {}x{} tiles from {}.", width, height, t_path);
+
+    return true;
+}
+
+bool Map::SetTile(const int t_mapX, const int t_mapY, const MapType t_mapType)
+{
+    if (is_position_not_on_map(t_mapX, t_mapY, m_width, m_height) || m_streamer)
+    {
+        return false;
+    }
+
+    // the mapped tiles are read-only; the file guarantees the padding after them
+    if (m_mapFile)
+    {
+        m_tiles.assign(m_tileData, m_tileData + static_cast<std::size_t>(m_width) * m_height + TILE_PADDING);
+        m_tileData = m_tiles.data();
+        m_mapFile.reset();
+    }
+
+    m_tiles[calc_map_index(t_mapX, t_mapY, m_width)] = static_cast<std::uint8_t>(t_mapType);
+    m_occupancy.SetWall(t_mapX, t_mapY, t_mapType == WALL);
+    ++m_version;
+
+    if (m_config.player.castMode == CastMode::DISTANCE_FIELD)
+    {
+        m_distanceField.Update(m_occupancy, t_mapX, t_mapY);
+    }
+
+    return true;
+}
+
+bool Map::UpdateStreaming(const olc::vi2d& t_mapPosition, const bool t_wait)
+{
+    if (!m_streamer)
+    {
+        return false;
+    }
+
+    const auto& metrics{ m_streamer->GetMetrics() };
+    const auto pageIns{ metrics.pageIns };
+    const auto evictions{ metrics.evictions };
+    const auto pendingChunks{ metrics.pendingChunks };
+
+    m_streamer->Update(t_mapPosition.x, t_mapPosition.y, m_occupancy);
+    if (t_wait)
+    {
+        m_streamer->Flush(m_occupancy);
+    }
+
+    // only page-ins and evictions of resident chunks touch the wall bits
+    const auto gridChanged{ metrics.pageIns != pageIns || metrics.evictions != evictions };
+    if (gridChanged)
+    {
+        ++m_version;
+    }
+
+    return gridChanged || metrics.pendingChunks != pendingChunks;
+}
+
+Map::MiniMapView Map::GetMiniMapView(const olc::vf2d& t_screenPosition) const
+{
+    const auto tileSize{ m_config.render.tileSize };
+    const auto scale{ m_config.render.miniMapScale };
+    const auto tilesX{ std::min(m_width, m_config.render.miniMapTiles) };
+    const auto tilesY{ std::min(m_height, m_config.render.miniMapTiles) };
+
+    // center the window on the position, but keep it inside the map
+    const auto center{ screen_to_map(t_screenPosition.x, t_screenPosition.y, tileSize) };
+    const auto firstX{ std::clamp(center.x - tilesX / 2, 0, m_width - tilesX) };
+    const auto firstY{ std::clamp(center.y - tilesY / 2, 0, m_height - tilesY) };
+
+    // the window's top left corner on the screen
+    const auto screenX{ static_cast<float>(m_config.render.screenWidth) - static_cast<float>(tilesX) * tileSize * scale };
+    const auto screenY{ static_cast<float>(m_config.render.screenHeight) - static_cast<float>(tilesY) * tileSize * scale };
+
+    return {
+        screenX - static_cast<float>(firstX) * tileSize * scale,
+        screenY - static_cast<float>(firstY) * tileSize * scale,
+        scale,
+        firstX, firstY,
+        firstX + tilesX, firstY + tilesY
+    };
+}
+
+void Map::RenderMiniMap(olc::PixelGameEngine* t_pge, const MiniMapView& t_view) const
+{
+    const auto scale{ t_view.scale * m_config.render.tileSize };
     const auto scaleInt{ static_cast<int>(scale) };
 
-    for (auto y{ 0 }; y < MAP_HEIGHT; ++y)
+    for (auto y{ t_view.firstY }; y < t_view.endY; ++y)
     {
-        for (auto x{ 0 }; x < MAP_WIDTH; ++x)
+        for (auto x{ t_view.firstX }; x < t_view.endX; ++x)
         {
-            const auto screenX{ t_screenX + static_cast<float>(x) * scale };
-            const auto screenY{ t_screenY + static_cast<float>(y) * scale };
+            const auto screenX{ t_view.xOffset + static_cast<float>(x) * scale };
+            const auto screenY{ t_view.yOffset + static_cast<float>(y) * scale };
             const auto screenXInt{ static_cast<int>(screenX) };
             const auto screenYInt{ static_cast<int>(screenY) };
 
@@ -43,142 +210,299 @@ void Map::RenderMiniMap(olc::PixelGameEngine* t_pge, const float t_screenX, cons
     }
 }
 
-void Map::Render(olc::PixelGameEngine* t_pge, const Player* t_player) const
+void Map::Render(olc::PixelGameEngine* t_pge, const Player* t_player, JobSystem& t_jobs)
 {
-    const auto projectionPlane{ Game::INI.Get<float>("map", "projection_plane") };
-    const auto screenWidth{ Game::INI.Get<int>("window", "width") };
-    const auto screenHeight{ Game::INI.Get<float>("window", "height") };
+    auto* target{ t_pge->GetDrawTarget() };
+
+    const auto projectionPlane{ m_config.render.projectionPlane };
+    const auto screenHeightInt{ std::min(m_config.render.screenHeight, target->height) };
+    const auto screenHeight{ static_cast<float>(m_config.render.screenHeight) };
     const auto screenHalfHeight{ screenHeight / 2.0f };
-    const auto screenHeightInt{ static_cast<int>(screenHeight) };
 
-    auto x{ 0 };
-    const auto rayLineWidth{ screenWidth / Game::INI.Get<int>("player", "nr_of_rays") };
+    const auto rayLineWidth{ m_config.render.rayLineWidth };
 
-    for (const auto& ray : t_player->rays)
-    {
-        const auto rayLength{ ray.length * cosf(ray.radians - t_player->radians) };
-        const auto wallHeight{ (projectionPlane / rayLength) * screenHeight };
-        const auto wallTop{ screenHalfHeight - wallHeight / 2.0f };
-        const auto wallBottom{ wallTop + wallHeight };
+    const auto& rays{ t_player->rays };
+    const auto lengths{ rays.GetLengths() };
+    const auto cosCorrections{ t_player->GetCameraTable().GetCosCorrections() };
+    const auto hitX{ rays.GetHitX() };
+    const auto hitY{ rays.GetHitY() };
+    const auto types{ rays.GetTypes() };
 
-        // wall
-        auto texture{ true };
-        if (texture)
-        {
-            RenderTexturedWall(
-                t_pge,
-                &ray,
-                static_cast<int>(wallTop),
-                static_cast<int>(wallBottom),
-                wallHeight,
-                x,
-                rayLineWidth
-            );
-        }
-        else
+    const auto tileSize{ m_config.render.tileSize };
+    const auto textureHeight{ m_texture->GetHeight() };
+    const auto levelCount{ m_texture->GetLevelCount() };
+    const auto mipmapping{ m_config.texture.mipmapping };
+    const auto mipBias{ m_config.texture.mipBias };
+
+    // the bands write disjoint columns of the target
+    std::atomic<std::size_t> pixelsWritten{ 0 };
+    auto renderBand{ [&](const int t_begin, const int t_end) {
+        std::size_t bandPixels{ 0 };
+        auto x{ t_begin * rayLineWidth };
+        for (auto i{ t_begin }; i < t_end; ++i)
         {
-            RenderPart(
-                t_pge,
-                x, static_cast<int>(wallTop),
-                rayLineWidth, static_cast<int>(wallHeight),
-                ray.type == Ray::VERTICAL ? olc::DARK_BLUE : olc::BLUE
-            );
+            const auto rayLength{ lengths[i] * cosCorrections[i] };
+            const auto wallHeight{ (projectionPlane / rayLength) * screenHeight };
+            const auto wallTop{ screenHalfHeight - wallHeight / 2.0f };
+            const auto wallBottom{ wallTop + wallHeight };
+
+            // the three spans of the column; every row belongs to exactly one of them
+            const auto wallStart{ std::clamp(static_cast<int>(wallTop), 0, screenHeightInt) };
+            const auto wallEnd{ std::clamp(static_cast<int>(wallBottom), wallStart, screenHeightInt) };
+
+            // top
+            bandPixels += RenderSpan(target, x, rayLineWidth, 0, wallStart, olc::GREY);
+
+            // wall
+            auto texture{ true };
+            if (texture)
+            {
+                const auto hitPosition{ types[i] == Ray::VERTICAL ? hitY[i] : hitX[i] };
+                const auto mipLevel{ mipmapping
+                    ? Texture::SelectMipLevel(wallHeight, textureHeight, levelCount, mipBias)
+                    : 0
+                };
+
+                bandPixels += RenderTexturedWall(
+                    target,
+                    Texture::SelectColumn(hitPosition, tileSize, m_texture->GetWidth(mipLevel)),
+                    mipLevel,
+                    types[i],
+                    static_cast<int>(wallTop),
+                    wallStart,
+                    wallEnd,
+                    wallHeight,
+                    x,
+                    rayLineWidth
+                );
+            }
+            else
+            {
+                bandPixels += RenderSpan(
+                    target,
+                    x, rayLineWidth,
+                    wallStart, wallEnd,
+                    types[i] == Ray::VERTICAL ? olc::DARK_BLUE : olc::BLUE
+                );
+            }
+
+            // bottom
+            bandPixels += RenderSpan(target, x, rayLineWidth, wallEnd, screenHeightInt, olc::DARK_GREY);
+
+            x += rayLineWidth;
         }
 
-        // bottom
-        RenderPart(
-            t_pge,
-            x, static_cast<int>(wallBottom),
-            rayLineWidth, screenHeightInt - static_cast<int>(wallBottom),
-            olc::DARK_GREY
-        );
+        pixelsWritten.fetch_add(bandPixels, std::memory_order_relaxed);
+    } };
 
-        // top
-        RenderPart(
-            t_pge,
-            x, 0,
-            rayLineWidth, screenHeightInt - static_cast<int>(wallBottom),
-            olc::GREY
-        );
+    t_jobs.ParallelFor(rays.Size(), m_config.threads.chunkSize, renderBand, "Render band");
+    m_pixelsWritten = pixelsWritten.load(std::memory_order_relaxed);
+}
 
-        x += rayLineWidth;
+bool Map::CoversView(const olc::PixelGameEngine* t_pge) const
+{
+    const auto* target{ t_pge->GetDrawTarget() };
+
+    return m_config.render.rayLineWidth * m_config.player.nrOfRays >= target->width &&
+           m_config.render.screenHeight >= target->height;
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+std::size_t Map::GetPixelsWritten() const
+{
+    return m_pixelsWritten;
+}
+
+int Map::GetWidth() const
+{
+    return m_width;
+}
+
+int Map::GetHeight() const
+{
+    return m_height;
+}
+
+TraceGrid Map::GetTraceGrid() const
+{
+    auto grid{ m_occupancy.GetTraceGrid(m_config.render.tileSize) };
+    if (m_config.player.castMode == CastMode::DISTANCE_FIELD && !m_streamer)
+    {
+        grid.pyramid = nullptr;
+        grid.distances = m_distanceField.GetDistances();
     }
+
+    return grid;
+}
+
+const ChunkStreamer* Map::GetStreamer() const
+{
+    return m_streamer.get();
+}
+
+std::uint64_t Map::GetVersion() const
+{
+    return m_version;
 }
 
 //-------------------------------------------------
 // Map value checks
 //-------------------------------------------------
 
-bool Map::IsMapTypeAtMapPosition(const int t_mapX, const int t_mapY, const MapType t_mapType)
+bool Map::IsMapTypeAtMapPosition(const int t_mapX, const int t_mapY, const MapType t_mapType) const
 {
-    return MAP.at(calc_map_index(t_mapX, t_mapY, MAP_WIDTH)) == t_mapType;
+    // there are only walls and empty tiles, so the wall bits answer both
+    return m_occupancy.IsWall(t_mapX, t_mapY) == (t_mapType == WALL);
 }
 
-bool Map::IsMapTypeAtScreenPosition(const float t_screenX, const float t_screenY, const MapType t_mapType)
+bool Map::IsMapTypeAtScreenPosition(const float t_screenX, const float t_screenY, const float t_tileSize, const MapType t_mapType) const
 {
-    const auto mapPosition{ screen_to_map(t_screenX, t_screenY, Game::INI.Get<float>("map", "tile_size")) };
+    const auto mapPosition{ screen_to_map(t_screenX, t_screenY, t_tileSize) };
     return IsMapTypeAtMapPosition(mapPosition.x, mapPosition.y, t_mapType);
 }
 
-bool Map::IsWallTypeAtMapPosition(const int t_mapX, const int t_mapY)
+bool Map::IsWallTypeAtMapPosition(const int t_mapX, const int t_mapY) const
 {
-    return MAP.at(calc_map_index(t_mapX, t_mapY, MAP_WIDTH)) == WALL;
+    return m_occupancy.IsWall(t_mapX, t_mapY);
+}
+
+//-------------------------------------------------
+// Init
+//-------------------------------------------------
+
+void Map::SetTiles(const int t_width, const int t_height, std::vector<std::uint8_t> t_tiles)
+{
+    FPS_ASSERT(t_tiles.size() == static_cast<std::size_t>(t_width) * t_height, "The tiles don't match the map size.");
+
+    m_width = t_width;
+    m_height = t_height;
+    m_tiles = std::move(t_tiles);
+    m_tiles.resize(m_tiles.size() + TILE_PADDING, EMPTY);
+    m_tileData = m_tiles.data();
+    m_streamer.reset();
+    m_mapFile.reset();
+    BuildTraceData();
+}
+
+void Map::BuildTraceData()
+{
+    m_occupancy.Build(m_tileData, m_width, m_height);
+    ++m_version;
+
+    if (m_config.player.castMode == CastMode::DISTANCE_FIELD)
+    {
+        m_distanceField.Build(m_occupancy);
+    }
+}
+
+void Map::CreateFallbackRoom()
+{
+    constexpr auto size{ 8 };
+
+    std::vector<std::uint8_t> tiles(size * size, EMPTY);
+    for (auto i{ 0 }; i < size; ++i)
+    {
+        tiles[calc_map_index(i, 0, size)] = WALL;
+        tiles[calc_map_index(i, size - 1, size)] = WALL;
+        tiles[calc_map_index(0, i, size)] = WALL;
+        tiles[calc_map_index(size - 1, i, size)] = WALL;
+    }
+
+    SetTiles(size, size, std::move(tiles));
 }
 
 //-------------------------------------------------
 // Render
 //-------------------------------------------------
 
-void Map::RenderTexturedWall(
-    olc::PixelGameEngine* t_pge,
-    const Ray* t_ray,
+int Map::RenderTexturedWall(
+    olc::Sprite* t_target,
+    const int t_textureX,
+    const int t_mipLevel,
+    const Ray::RayType t_type,
     const int t_wallTop,
-    const int t_wallBottom,
+    const int t_yStart,
+    const int t_yEnd,
     const float t_wallHeight,
     const int t_x,
     const int t_rayLineWidth
 ) const
 {
+    // clip once per column
+    const auto xStart{ std::max(t_x, 0) };
+    const auto xEnd{ std::min(t_x + t_rayLineWidth, t_target->width) };
+    const auto yStart{ std::max(t_yStart, 0) };
+    const auto yEnd{ std::min(t_yEnd, t_target->height) };
 
-    auto shadow{ 1.0f };
-
-    int textureX = static_cast<int>(t_ray->screenHitPosition.x) % 64;
-    if (t_ray->type == Ray::VERTICAL) {
-        shadow = 0.7f;
-        textureX = static_cast<int>(t_ray->screenHitPosition.y) % 64;
+    if (xStart >= xEnd || yStart >= yEnd)
+    {
+        return 0;
     }
 
-    for (auto y{ t_wallTop }; y < t_wallBottom; ++y)
-    {
-        const auto yf{ static_cast<float>(y) };
-        const auto wtf{ static_cast<float>(t_wallTop) };
+    // 16.16 fixed-point texture row, stepped once per screen row
+    const auto textureHeight{ m_texture->GetHeight(t_mipLevel) };
+    const auto maxRow{ static_cast<std::int64_t>(textureHeight - 1) };
+    const auto step{ static_cast<std::int64_t>(static_cast<float>(textureHeight) * 65536.0f / t_wallHeight) };
+    auto textureY{ static_cast<std::int64_t>(yStart - t_wallTop) * step };
 
-        auto textureY{ static_cast<int>((yf - wtf) / t_wallHeight * 64) };
+    // 0.7 shadow for vertical walls as 8-bit fixed-point factor
+    const auto shadow{ t_type == Ray::VERTICAL ? 179u : 256u };
 
-        if (textureY < 0)
-        {
-            textureY = 0;
-        }
+    // the texels of a texture column are contiguous
+    const auto* texels{ m_texture->GetColumn(t_textureX, t_mipLevel) };
+    const auto targetWidth{ t_target->width };
+    const auto runLength{ xEnd - xStart };
+    auto* row{ t_target->GetData() + yStart * targetWidth + xStart };
 
-        if (textureY >= 64)
-        {
-            textureY = 63;
-        }
+    for (auto y{ yStart }; y < yEnd; ++y)
+    {
+        const auto texel{ texels[std::min(textureY >> 16, maxRow)] };
+        const olc::Pixel pixel{
+            static_cast<std::uint8_t>((texel.r * shadow) >> 8),
+            static_cast<std::uint8_t>((texel.g * shadow) >> 8),
+            static_cast<std::uint8_t>((texel.b * shadow) >> 8),
+            texel.a
+        };
+
+        // write the run of a ray that covers more than one column
+        std::fill_n(row, runLength, pixel);
 
-        t_pge->FillRect(
-            t_x, y,
-            t_rayLineWidth, 1,
-            m_texture->GetPixel(textureX, textureY) * shadow
-        );
+        row += targetWidth;
+        textureY += step;
     }
+
+    return runLength * (yEnd - yStart);
 }
 
-void Map::RenderPart(
-    olc::PixelGameEngine* t_pge,
-    const int t_startX, const int t_startY,
-    const int t_width, const int t_height,
+int Map::RenderSpan(
+    olc::Sprite* t_target,
+    const int t_x, const int t_width,
+    const int t_yStart, const int t_yEnd,
     const olc::Pixel t_color
 )
 {
-    t_pge->FillRect(t_startX, t_startY, t_width, t_height, t_color);
+    const auto xStart{ std::max(t_x, 0) };
+    const auto xEnd{ std::min(t_x + t_width, t_target->width) };
+    const auto yStart{ std::max(t_yStart, 0) };
+    const auto yEnd{ std::min(t_yEnd, t_target->height) };
+
+    if (xStart >= xEnd || yStart >= yEnd)
+    {
+        return 0;
+    }
+
+    const auto targetWidth{ t_target->width };
+    const auto runLength{ xEnd - xStart };
+    auto* row{ t_target->GetData() + yStart * targetWidth + xStart };
+
+    for (auto y{ yStart }; y < yEnd; ++y)
+    {
+        std::fill_n(row, runLength, t_color);
+        row += targetWidth;
+    }
+
+    return runLength * (yEnd - yStart);
 }
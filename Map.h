@@ -1,13 +1,24 @@
 #pragma once
 
+#include <cstdint>
+#include <string>
+#include <vector>
 #include "olcPixelGameEngine.h"
+#include "ChunkStreamer.h"
+#include "Config.h"
+#include "DistanceField.h"
+#include "MapFile.h"
+#include "OccupancyGrid.h"
+#include "Ray.h"
+#include "RayTrace.h"
+#include "Texture.h"
 
 //-------------------------------------------------
 // Forward declarations
 //-------------------------------------------------
 
 class Player;
-class Ray;
+class JobSystem;
 
 //-------------------------------------------------
 // Map
@@ -31,39 +42,63 @@ public:
         EMPTY, WALL
     };
 
+    /**
+     * @brief The part of the map shown on the mini-map and where it is drawn.
+     */
+    struct MiniMapView
+    {
+        /**
+         * @brief The screen position of map position (0, 0); may be far outside the screen.
+         */
+        float xOffset{ 0.0f };
+        float yOffset{ 0.0f };
+
+        /**
+         * @brief Screen pixels per screen unit of the map.
+         */
+        float scale{ 1.0f };
+
+        /**
+         * @brief The visible tiles, [firstX, endX) x [firstY, endY).
+         */
+        int firstX{ 0 };
+        int firstY{ 0 };
+        int endX{ 0 };
+        int endY{ 0 };
+    };
+
     //-------------------------------------------------
     // Constants
     //-------------------------------------------------
 
     /**
-     * @brief The width of the map (number of tiles).
+     * @brief Readable bytes after the last tile; the binary level format reserves them, so the
+     *        tiles can be read with 32-bit loads.
      */
-    static constexpr auto MAP_WIDTH{ 8 };
+    static constexpr auto TILE_PADDING{ 3 };
+
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
 
     /**
-     * @brief The height of the map (number of tiles).
+     * @brief Constructs a new Map object, loads the configured level and the wall texture.
+     *
+     * If the level can't be loaded, a walled 8x8 room is used instead.
+     *
+     * @param t_config The config snapshot, which must outlive the map.
      */
-    static constexpr auto MAP_HEIGHT{ 8 };
+    explicit Map(const Config& t_config);
 
     /**
-     * @brief Array representing the map layout.
+     * @brief Constructs a new Map object from tiles created in memory and loads the wall texture.
+     *
+     * @param t_config The config snapshot, which must outlive the map.
+     * @param t_width The width of the map (number of tiles).
+     * @param t_height The height of the map (number of tiles).
+     * @param t_tiles Row-major MapType values, t_width * t_height entries.
      */
-    static constexpr std::array<int, MAP_WIDTH * MAP_HEIGHT> MAP{
-        WALL,  WALL,  WALL,  WALL,   WALL,  WALL,  WALL, WALL,
-        WALL, EMPTY,  WALL, EMPTY,  EMPTY, EMPTY, EMPTY, WALL,
-        WALL, EMPTY,  WALL,  WALL,   WALL, EMPTY, EMPTY, WALL,
-        WALL, EMPTY, EMPTY, EMPTY,  EMPTY, EMPTY, EMPTY, WALL,
-        WALL, EMPTY, EMPTY, EMPTY,  EMPTY, EMPTY, EMPTY, WALL,
-        WALL, EMPTY, EMPTY, EMPTY,  EMPTY, EMPTY, EMPTY, WALL,
-        WALL, EMPTY, EMPTY, EMPTY,  EMPTY, EMPTY, EMPTY, WALL,
-        WALL,  WALL,  WALL,  WALL,   WALL,  WALL,  WALL, WALL,
-    };
-
-    //-------------------------------------------------
-    // Ctors. / Dtor.
-    //-------------------------------------------------
-
-    Map();
+    Map(const Config& t_config, int t_width, int t_height, std::vector<std::uint8_t> t_tiles);
 
     Map(const Map& t_other) = delete;
     Map(Map&& t_other) noexcept = delete;
@@ -76,19 +111,65 @@ public:
     // Logic
     //-------------------------------------------------
 
+    /**
+     * @brief Loads a binary level (see MapFile) or a text level (see parse_text_map()).
+     *
+     * Binary levels are memory-mapped and their tiles are used in place. With streaming
+     * enabled, their chunks are paged in by UpdateStreaming() instead of all at once.
+     *
+     * @param t_path The path to the level file.
+     *
+     * @return True if the level was loaded, otherwise false and the map is unchanged.
+     */
+    bool LoadFromFile(const std::string& t_path);
+
+    /**
+     * @brief Changes a single tile and updates the wall bits and the distance field around it.
+     *
+     * The tiles of a binary level are copied out of the mapped file on the first change.
+     *
+     * @param t_mapX The x-coordinate on the map.
+     * @param t_mapY The y-coordinate on the map.
+     * @param t_mapType The new type of the tile.
+     *
+     * @return False if the position is outside the map or the level is streamed, otherwise true.
+     */
+    bool SetTile(int t_mapX, int t_mapY, MapType t_mapType);
+
+    /**
+     * @brief Pages the chunks of a streamed level in and out around a map position.
+     *
+     * Does nothing if the level is fully loaded.
+     *
+     * @param t_mapPosition The map position to stream around, usually the player's.
+     * @param t_wait If true, waits until the requested chunks are resident, e.g. before the first frame.
+     *
+     * @return True if a chunk was requested, paged in or evicted, otherwise false.
+     */
+    bool UpdateStreaming(const olc::vi2d& t_mapPosition, bool t_wait = false);
+
+    /**
+     * @brief Computes the window of tiles around a screen position that the mini-map shows.
+     *
+     * The window is placed in the bottom right corner of the screen and is at most
+     * m_config.render.miniMapTiles tiles wide and high.
+     *
+     * @param t_screenPosition The screen position to center, usually the player's.
+     *
+     * @return The mini-map view.
+     */
+    [[nodiscard]] MiniMapView GetMiniMapView(const olc::vf2d& t_screenPosition) const;
+
     /**
      * @brief Renders the mini-map on the screen.
      *
-     * This method draws a small top-down view of the map, showing the walls, empty spaces,
-     * and possibly the player's position, depending on how the map and player are represented.
+     * This method draws a small top-down view of the tiles inside the view's window,
+     * showing the walls and empty spaces.
      *
      * @param t_pge Pointer to the PixelGameEngine object.
-     * @param t_screenX The x-coordinate on the screen where the mini-map should be drawn.
-     * @param t_screenY The y-coordinate on the screen where the mini-map should be drawn.
-     * @param t_scale The scaling factor for the mini-map. Values greater than 1.0 will enlarge the map,
-     *                while values less than 1.0 will shrink it.
+     * @param t_view The part of the map to draw and where to draw it.
      */
-    static void RenderMiniMap(olc::PixelGameEngine* t_pge, float t_screenX, float t_screenY, float t_scale);
+    void RenderMiniMap(olc::PixelGameEngine* t_pge, const MiniMapView& t_view) const;
 
     /**
      * @brief Renders the 3D view of the map based on the player's position and perspective.
@@ -97,10 +178,58 @@ public:
      * It uses raycasting to determine the distance to walls and renders them with appropriate
      * height and texture mapping, simulating a first-person perspective.
      *
+     * Each screen column is composed in a single pass: the ceiling, wall and floor spans are
+     * computed up front and every pixel of the column is written exactly once. Bands of
+     * columns are composed as separate jobs.
+     *
      * @param t_pge Pointer to the PixelGameEngine object.
      * @param t_player Pointer to the player object.
+     * @param t_jobs The job system to compose the column bands on.
      */
-    void Render(olc::PixelGameEngine* t_pge, const Player* t_player) const;
+    void Render(olc::PixelGameEngine* t_pge, const Player* t_player, JobSystem& t_jobs);
+
+    /**
+     * @brief Checks whether Render() writes every pixel of the draw target.
+     *
+     * @param t_pge Pointer to the PixelGameEngine object.
+     *
+     * @return True if a full-screen clear before Render() is unnecessary, otherwise false.
+     */
+    [[nodiscard]] bool CoversView(const olc::PixelGameEngine* t_pge) const;
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    /**
+     * @brief The number of pixels written by the last Render() call.
+     */
+    [[nodiscard]] std::size_t GetPixelsWritten() const;
+
+    /**
+     * @brief The width of the map (number of tiles).
+     */
+    [[nodiscard]] int GetWidth() const;
+
+    /**
+     * @brief The height of the map (number of tiles).
+     */
+    [[nodiscard]] int GetHeight() const;
+
+    /**
+     * @brief A view of the tiles for the ray traversal in the configured CastMode.
+     */
+    [[nodiscard]] TraceGrid GetTraceGrid() const;
+
+    /**
+     * @brief The chunk streamer of a streamed level, otherwise null.
+     */
+    [[nodiscard]] const ChunkStreamer* GetStreamer() const;
+
+    /**
+     * @brief Counts the changes of the wall bits: loads, SetTile() calls, page-ins and evictions.
+     */
+    [[nodiscard]] std::uint64_t GetVersion() const;
 
     //-------------------------------------------------
     // Map value checks
@@ -114,19 +243,21 @@ public:
      * @param t_mapType Type of tile to check for.
      *
      * @return True if the specified MapType is present at the given coordinates, otherwise false.
+     *         Positions outside the map count as WALL.
      */
-    [[nodiscard]] static bool IsMapTypeAtMapPosition(int t_mapX, int t_mapY, MapType t_mapType);
+    [[nodiscard]] bool IsMapTypeAtMapPosition(int t_mapX, int t_mapY, MapType t_mapType) const;
 
     /**
      * @brief Checks if a specific MapType exists at the given screen coordinates.
      *
      * @param t_screenX The x-coordinate on the screen.
      * @param t_screenY The y-coordinate on the screen.
+     * @param t_tileSize The size of each tile.
      * @param t_mapType Type of tile to check for.
      *
      * @return True if the specified MapType is present at the given screen coordinates, otherwise false.
      */
-    [[nodiscard]] static bool IsMapTypeAtScreenPosition(float t_screenX, float t_screenY, MapType t_mapType);
+    [[nodiscard]] bool IsMapTypeAtScreenPosition(float t_screenX, float t_screenY, float t_tileSize, MapType t_mapType) const;
 
     /**
      * @brief Checks if a wall exists at the given map coordinates.
@@ -134,9 +265,9 @@ public:
      * @param t_mapX The x-coordinate on the map.
      * @param t_mapY The y-coordinate on the map.
      *
-     * @return True if there is a wall at the specified coordinates, otherwise false.
+     * @return True if there is a wall at the specified coordinates or they are outside the map, otherwise false.
      */
-    [[nodiscard]] static bool IsWallTypeAtMapPosition(int t_mapX, int t_mapY);
+    [[nodiscard]] bool IsWallTypeAtMapPosition(int t_mapX, int t_mapY) const;
 
 protected:
 
@@ -145,29 +276,137 @@ private:
     // Member
     //-------------------------------------------------
 
+    /**
+     * @brief The config snapshot.
+     */
+    const Config& m_config;
+
+    /**
+     * @brief The width of the map (number of tiles).
+     */
+    int m_width{ 0 };
+
+    /**
+     * @brief The height of the map (number of tiles).
+     */
+    int m_height{ 0 };
+
+    /**
+     * @brief Row-major MapType values, one byte per tile, followed by TILE_PADDING bytes.
+     */
+    std::vector<std::uint8_t> m_tiles;
+
+    /**
+     * @brief The mapped binary level, if the tiles come from one.
+     */
+    std::unique_ptr<MapFile> m_mapFile;
+
+    /**
+     * @brief Pages the chunks of m_mapFile into m_occupancy, if the level is streamed;
+     *        declared after m_mapFile, so it stops reading before the file is unmapped.
+     */
+    std::unique_ptr<ChunkStreamer> m_streamer;
+
+    /**
+     * @brief The tiles in use, either m_tiles or the tile layer of m_mapFile.
+     */
+    const std::uint8_t* m_tileData{ nullptr };
+
+    /**
+     * @brief The wall bits of m_tileData, used by the traversal and the collision checks.
+     *        Holds only the resident chunks if the level is streamed.
+     */
+    OccupancyGrid m_occupancy;
+
+    /**
+     * @brief The distance to the nearest wall of each tile; only built for CastMode::DISTANCE_FIELD
+     *        and levels that aren't streamed.
+     */
+    DistanceField m_distanceField;
+
+    /**
+     * @brief Incremented whenever m_occupancy changes, so cached ray results can tell they are stale.
+     */
+    std::uint64_t m_version{ 0 };
+
     /**
      * @brief A texture used for rendering walls hit by rays.
      */
-    std::unique_ptr<olc::Sprite> m_texture;
+    std::unique_ptr<Texture> m_texture;
+
+    /**
+     * @brief The number of pixels written by the last Render() call.
+     */
+    std::size_t m_pixelsWritten{ 0 };
+
+    //-------------------------------------------------
+    // Init
+    //-------------------------------------------------
+
+    /**
+     * @brief Takes over a row-major tile layout and pads it for the ray traversal.
+     */
+    void SetTiles(int t_width, int t_height, std::vector<std::uint8_t> t_tiles);
+
+    /**
+     * @brief Rebuilds the wall bits and, if needed, the distance field from m_tileData.
+     */
+    void BuildTraceData();
+
+    /**
+     * @brief Creates a walled 8x8 room.
+     */
+    void CreateFallbackRoom();
 
     //-------------------------------------------------
     // Render
     //-------------------------------------------------
 
-    void RenderTexturedWall(
-        olc::PixelGameEngine* t_pge,
-        const Ray* t_ray,
+    /**
+     * @brief Writes a textured wall span straight into the draw target's pixel data.
+     *
+     * @param t_target The sprite to draw into.
+     * @param t_textureX The texture column to sample, in texels of the mip level.
+     * @param t_mipLevel The mip level to sample.
+     * @param t_type The side of the wall, vertical walls are shaded.
+     * @param t_wallTop The unclipped first screen row of the wall, may be outside the screen.
+     * @param t_yStart The first screen row to write.
+     * @param t_yEnd One past the last screen row to write.
+     * @param t_wallHeight The unclipped height of the wall.
+     * @param t_x The first screen column.
+     * @param t_rayLineWidth The number of screen columns to fill.
+     *
+     * @return The number of pixels written.
+     */
+    int RenderTexturedWall(
+        olc::Sprite* t_target,
+        int t_textureX,
+        int t_mipLevel,
+        Ray::RayType t_type,
         int t_wallTop,
-        int t_wallBottom,
+        int t_yStart,
+        int t_yEnd,
         float t_wallHeight,
         int t_x,
         int t_rayLineWidth
     ) const;
 
-    static void RenderPart(
-        olc::PixelGameEngine* t_pge,
-        int t_startX, int t_startY,
-        int t_width, int t_height,
+    /**
+     * @brief Fills a span of rows of one or more screen columns with a color.
+     *
+     * @param t_target The sprite to draw into.
+     * @param t_x The first screen column.
+     * @param t_width The number of screen columns.
+     * @param t_yStart The first screen row.
+     * @param t_yEnd One past the last screen row.
+     * @param t_color The fill color.
+     *
+     * @return The number of pixels written.
+     */
+    static int RenderSpan(
+        olc::Sprite* t_target,
+        int t_x, int t_width,
+        int t_yStart, int t_yEnd,
         olc::Pixel t_color
     );
 };
@@ -0,0 +1,108 @@
+#define OLC_PGE_APPLICATION
+#include <fstream>
+#include <string>
+#include <vector>
+#include "olcPixelGameEngine.h"
+#include "Map.h"
+#include "MapFile.h"
+#include "Log.h"
+
+//-------------------------------------------------
+// Load
+//-------------------------------------------------
+
+/**
+ * @brief Reads a text level, see parse_text_map().
+ */
+static bool load_text(const std::string& t_path, int& t_width, int& t_height, std::vector<std::uint8_t>& t_tiles)
+{
+    std::ifstream file{ t_path, std::ios::binary };
+    if (!file)
+    {
+        FPS_LOG_ERROR("[load_text()] Unable to open {}.", t_path);
+        return false;
+    }
+
+    const std::string text{ std::istreambuf_iterator<char>{ file }, {} };
+
+    return parse_text_map(text, t_width, t_height, t_tiles);
+}
+
+/**
+ * @brief Reads an image level; every dark pixel (luma < 128) is a wall.
+ */
+static bool load_image(const std::string& t_path, int& t_width, int& t_height, std::vector<std::uint8_t>& t_tiles)
+{
+    const olc::Sprite sprite{ t_path };
+    if (sprite.width == 0 || sprite.height == 0)
+    {
+        FPS_LOG_ERROR("[load_image()] Unable to load {}.", t_path);
+        return false;
+    }
+
+    t_width = sprite.width;
+    t_height = sprite.height;
+    t_tiles.assign(static_cast<std::size_t>(t_width) * t_height, Map::EMPTY);
+
+    for (auto y{ 0 }; y < t_height; ++y)
+    {
+        for (auto x{ 0 }; x < t_width; ++x)
+        {
+            const auto p{ sprite.GetPixel(x, y) };
+            const auto luma{ (299 * p.r + 587 * p.g + 114 * p.b) / 1000 };
+            if (luma < 128)
+            {
+                t_tiles[static_cast<std::size_t>(y) * t_width + x] = Map::WALL;
+            }
+        }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------
+// Main
+//-------------------------------------------------
+
+int main(const int t_argc, char* t_argv[])
+{
+    Log::Init();
+
+    // mapbake <input.map|input.png> <output> [metadata]
+    if (t_argc < 3)
+    {
+        std::printf("usage: mapbake <input.map|input.png> <output> [metadata]\n");
+        return 2;
+    }
+
+    // sets up the sprite loader for PNG input; no window is created
+    olc::PixelGameEngine pge;
+
+    const std::string input{ t_argv[1] };
+    const std::string output{ t_argv[2] };
+    const std::string metadata{ t_argc > 3 ? t_argv[3] : "" };
+
+    auto width{ 0 };
+    auto height{ 0 };
+    std::vector<std::uint8_t> tiles;
+    const auto isImage{ input.ends_with(".png") || input.ends_with(".PNG") };
+    if (!(isImage ? load_image(input, width, height, tiles) : load_text(input, width, height, tiles)))
+    {
+        return 1;
+    }
+
+    if (!MapFile::Write(output, width, height, tiles, metadata))
+    {
+        return 1;
+    }
+
+    // read it back, so a bad file never leaves the tool
+    if (MapFile check; !check.Open(output))
+    {
+        return 1;
+    }
+
+    FPS_LOG_INFO("[main()] Baked {}x{} tiles from {} into {}.", width, height, input, output);
+
+    return 0;
+}
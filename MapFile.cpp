@@ -0,0 +1,408 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MapFile.h"
+#include "Map.h"
+#include "Log.h"
+
+static_assert(std::endian::native == std::endian::little, "The binary level format is little-endian.");
+static_assert(sizeof(MapFile::MapFileHeader) == 64);
+static_assert(sizeof(MapFile::MapFileLayer) == 32);
+
+namespace
+{
+    constexpr std::uint64_t LAYER_ALIGNMENT{ 64 };
+
+    std::uint64_t align_up(const std::uint64_t t_value, const std::uint64_t t_alignment)
+    {
+        return (t_value + t_alignment - 1) / t_alignment * t_alignment;
+    }
+}
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+MapFile::~MapFile() noexcept
+{
+    Close();
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+bool MapFile::Open(const std::string& t_path, const bool t_checkTiles)
+{
+    Close();
+
+    m_fd = open(t_path.c_str(), O_RDONLY);
+    if (m_fd < 0)
+    {
+        FPS_LOG_ERROR("[MapFile::Open()] Unable to open {}.", t_path);
+        return false;
+    }
+
+    struct stat info{};
+    if (fstat(m_fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(MapFileHeader)))
+    {
+        FPS_LOG_ERROR("[MapFile::Open()] {} is too small for a level header.", t_path);
+        Close();
+        return false;
+    }
+
+    m_size = static_cast<std::size_t>(info.st_size);
+    auto* data{ mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0) };
+    if (data == MAP_FAILED)
+    {
+        FPS_LOG_ERROR("[MapFile::Open()] Unable to map {}.", t_path);
+        m_size = 0;
+        Close();
+        return false;
+    }
+    m_data = static_cast<const std::uint8_t*>(data);
+
+    if (!Validate(t_path, t_checkTiles))
+    {
+        Close();
+        return false;
+    }
+
+    FPS_LOG_DEBUG("[MapFile::Open()] Mapped {}x{} tiles from {}.", m_width, m_height, t_path);
+
+    return true;
+}
+
+bool MapFile::IsMapFile(const std::string& t_path)
+{
+    std::ifstream file{ t_path, std::ios::binary };
+    char magic[sizeof(MAGIC)]{};
+
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool MapFile::Write(
+    const std::string& t_path,
+    const int t_width, const int t_height,
+    const std::span<const std::uint8_t> t_tiles,
+    const std::string_view t_metadata
+)
+{
+    const auto tileCount{ static_cast<std::uint64_t>(t_width) * static_cast<std::uint64_t>(t_height) };
+    if (t_width <= 0 || t_height <= 0 || t_tiles.size() < tileCount)
+    {
+        FPS_LOG_ERROR("[MapFile::Write()] Invalid map size {}x{} for {} tiles.", t_width, t_height, t_tiles.size());
+        return false;
+    }
+
+    // the layer contents and where they go; each layer is followed by at least TILE_PADDING zero bytes
+    std::vector<std::pair<MapFileLayer, const void*>> layers;
+    layers.push_back({ { TILES, 0, 0, tileCount, Checksum(t_tiles.data(), tileCount) }, t_tiles.data() });
+    if (!t_metadata.empty())
+    {
+        layers.push_back({ { METADATA, 0, 0, t_metadata.size(), Checksum(t_metadata.data(), t_metadata.size()) }, t_metadata.data() });
+    }
+
+    auto offset{ align_up(sizeof(MapFileHeader) + layers.size() * sizeof(MapFileLayer), LAYER_ALIGNMENT) };
+    for (auto& [layer, data] : layers)
+    {
+        layer.offset = offset;
+        offset = align_up(offset + layer.size + Map::TILE_PADDING, LAYER_ALIGNMENT);
+    }
+    const auto fileSize{ offset };
+
+    std::vector<MapFileLayer> table;
+    for (const auto& [layer, data] : layers)
+    {
+        table.push_back(layer);
+    }
+
+    MapFileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(MapFileHeader);
+    header.width = static_cast<std::uint32_t>(t_width);
+    header.height = static_cast<std::uint32_t>(t_height);
+    header.layerCount = static_cast<std::uint32_t>(table.size());
+    header.layerTableOffset = sizeof(MapFileHeader);
+    header.layerTableChecksum = Checksum(table.data(), table.size() * sizeof(MapFileLayer));
+    header.headerChecksum = Checksum(&header, offsetof(MapFileHeader, headerChecksum));
+
+    std::ofstream file{ t_path, std::ios::binary | std::ios::trunc };
+    if (!file)
+    {
+        FPS_LOG_ERROR("[MapFile::Write()] Unable to create {}.", t_path);
+        return false;
+    }
+
+    const std::vector<char> zeros(LAYER_ALIGNMENT + Map::TILE_PADDING, 0);
+    auto position{ static_cast<std::uint64_t>(0) };
+    const auto writeBytes{ [&](const void* t_data, const std::uint64_t t_size) {
+        file.write(static_cast<const char*>(t_data), static_cast<std::streamsize>(t_size));
+        position += t_size;
+    } };
+    const auto padTo{ [&](const std::uint64_t t_offset) {
+        writeBytes(zeros.data(), t_offset - position);
+    } };
+
+    writeBytes(&header, sizeof(header));
+    writeBytes(table.data(), table.size() * sizeof(MapFileLayer));
+    for (const auto& [layer, data] : layers)
+    {
+        padTo(layer.offset);
+        writeBytes(data, layer.size);
+    }
+    padTo(fileSize);
+
+    if (!file.flush())
+    {
+        FPS_LOG_ERROR("[MapFile::Write()] Unable to write {}.", t_path);
+        return false;
+    }
+
+    return true;
+}
+
+std::uint64_t MapFile::Checksum(const void* t_data, const std::size_t t_size)
+{
+    constexpr std::uint64_t prime{ 0x100000001b3ull };
+    const auto* bytes{ static_cast<const std::uint8_t*>(t_data) };
+
+    // four independent lanes, so the multiplies don't wait for each other
+    std::uint64_t lanes[4]{
+        0x9e3779b97f4a7c15ull ^ t_size, 0xbf58476d1ce4e5b9ull, 0x94d049bb133111ebull, 0xcbf29ce484222325ull
+    };
+
+    std::size_t i{ 0 };
+    for (; i + 32 <= t_size; i += 32)
+    {
+        for (auto lane{ 0 }; lane < 4; ++lane)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i + lane * 8, sizeof(word));
+            lanes[lane] = (lanes[lane] ^ word) * prime;
+        }
+    }
+    for (; i < t_size; ++i)
+    {
+        lanes[0] = (lanes[0] ^ bytes[i]) * prime;
+    }
+
+    auto hash{ lanes[0] ^ std::rotl(lanes[1], 16) ^ std::rotl(lanes[2], 32) ^ std::rotl(lanes[3], 48) };
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+bool MapFile::AreTilesValid(const std::uint8_t* t_tiles, const std::size_t t_count)
+{
+    return t_count == 0 || *std::max_element(t_tiles, t_tiles + t_count) <= Map::WALL;
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+int MapFile::GetWidth() const
+{
+    return m_width;
+}
+
+int MapFile::GetHeight() const
+{
+    return m_height;
+}
+
+const std::uint8_t* MapFile::GetTiles() const
+{
+    return m_tiles;
+}
+
+std::string_view MapFile::GetMetadata() const
+{
+    return m_metadata;
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+bool MapFile::Validate(const std::string& t_path, const bool t_checkTiles)
+{
+    MapFileHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        FPS_LOG_ERROR("[MapFile::Validate()] {} is not a binary level.", t_path);
+        return false;
+    }
+
+    if (header.version == 0 || header.version > VERSION)
+    {
+        FPS_LOG_ERROR("[MapFile::Validate()] {} has the unsupported version {}.", t_path, header.version);
+        return false;
+    }
+
+    if (header.headerSize != sizeof(MapFileHeader) ||
+        header.headerChecksum != Checksum(m_data, offsetof(MapFileHeader, headerChecksum)))
+    {
+        FPS_LOG_ERROR("[MapFile::Validate()] {} has a corrupt header.", t_path);
+        return false;
+    }
+
+    const auto tableSize{ static_cast<std::uint64_t>(header.layerCount) * sizeof(MapFileLayer) };
+    if (header.layerTableOffset % alignof(MapFileLayer) != 0 ||
+        header.layerTableOffset > m_size || tableSize > m_size - header.layerTableOffset ||
+        header.layerTableChecksum != Checksum(m_data + header.layerTableOffset, tableSize))
+    {
+        FPS_LOG_ERROR("[MapFile::Validate()] {} has a corrupt layer table.", t_path);
+        return false;
+    }
+
+    const auto tileCount{ static_cast<std::uint64_t>(header.width) * header.height };
+    if (header.width == 0 || header.height == 0 || header.width > INT32_MAX / header.height)
+    {
+        FPS_LOG_ERROR("[MapFile::Validate()] {} has the invalid size {}x{}.", t_path, header.width, header.height);
+        return false;
+    }
+
+    const auto* table{ reinterpret_cast<const MapFileLayer*>(m_data + header.layerTableOffset) };
+    const std::uint8_t* tiles{ nullptr };
+    std::string_view metadata;
+
+    for (std::uint32_t i{ 0 }; i < header.layerCount; ++i)
+    {
+        const auto& layer{ table[i] };
+
+        // the padding after a layer is part of the format, so the tiles can be gathered in place;
+        // the size comes from the file, so it is compared against the room left and never added to
+        if (layer.offset > m_size || m_size - layer.offset < Map::TILE_PADDING ||
+            layer.size > m_size - layer.offset - Map::TILE_PADDING)
+        {
+            FPS_LOG_ERROR("[MapFile::Validate()] Layer {} of {} is out of bounds.", i, t_path);
+            return false;
+        }
+
+        // a streamed level's tiles are read chunk by chunk on the streamer's thread
+        const auto checked{ layer.type != TILES || t_checkTiles };
+        if (checked && layer.checksum != Checksum(m_data + layer.offset, layer.size))
+        {
+            FPS_LOG_ERROR("[MapFile::Validate()] Layer {} of {} has a checksum mismatch.", i, t_path);
+            return false;
+        }
+
+        if (layer.type == TILES)
+        {
+            if (layer.size != tileCount)
+            {
+                FPS_LOG_ERROR("[MapFile::Validate()] The tile layer of {} doesn't match the map size.", t_path);
+                return false;
+            }
+            tiles = m_data + layer.offset;
+        }
+        else if (layer.type == METADATA)
+        {
+            metadata = { reinterpret_cast<const char*>(m_data + layer.offset), layer.size };
+        }
+    }
+
+    if (!tiles)
+    {
+        FPS_LOG_ERROR("[MapFile::Validate()] {} has no tile layer.", t_path);
+        return false;
+    }
+
+    if (t_checkTiles && !AreTilesValid(tiles, tileCount))
+    {
+        FPS_LOG_ERROR("[MapFile::Validate()] {} contains unknown tile values.", t_path);
+        return false;
+    }
+
+    m_width = static_cast<int>(header.width);
+    m_height = static_cast<int>(header.height);
+    m_tiles = tiles;
+    m_metadata = metadata;
+
+    return true;
+}
+
+void MapFile::Close()
+{
+    if (m_data)
+    {
+        munmap(const_cast<std::uint8_t*>(m_data), m_size);
+    }
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+    }
+
+    m_fd = -1;
+    m_data = nullptr;
+    m_size = 0;
+    m_width = 0;
+    m_height = 0;
+    m_tiles = nullptr;
+    m_metadata = {};
+}
+
+//-------------------------------------------------
+// Text levels
+//-------------------------------------------------
+
+bool parse_text_map(const std::string_view t_text, int& t_width, int& t_height, std::vector<std::uint8_t>& t_tiles)
+{
+    // first pass: the dimensions
+    auto width{ 0 };
+    auto height{ 0 };
+    for (std::size_t begin{ 0 }; begin < t_text.size();)
+    {
+        const auto newline{ t_text.find('\n', begin) };
+        const auto end{ newline == std::string_view::npos ? t_text.size() : newline };
+        const auto length{ end > begin && t_text[end - 1] == '\r' ? end - begin - 1 : end - begin };
+
+        width = std::max(width, static_cast<int>(length));
+        ++height;
+        begin = end + 1;
+    }
+
+    if (width == 0 || height == 0)
+    {
+        return false;
+    }
+
+    // second pass: the tiles
+    t_tiles.assign(static_cast<std::size_t>(width) * height, Map::EMPTY);
+    auto* row{ t_tiles.data() };
+    for (std::size_t begin{ 0 }; begin < t_text.size();)
+    {
+        const auto newline{ t_text.find('\n', begin) };
+        const auto end{ newline == std::string_view::npos ? t_text.size() : newline };
+
+        for (auto i{ begin }; i < end; ++i)
+        {
+            const auto c{ t_text[i] };
+            if (c == '#' || c == '1')
+            {
+                row[i - begin] = Map::WALL;
+            }
+        }
+
+        row += width;
+        begin = end + 1;
+    }
+
+    t_width = width;
+    t_height = height;
+
+    return true;
+}
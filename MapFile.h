@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//-------------------------------------------------
+// MapFile
+//-------------------------------------------------
+
+/**
+ * @brief A binary level, memory-mapped and used in place.
+ *
+ * Layout (little-endian):
+ *  - MapFileHeader at offset 0
+ *  - layerCount MapFileLayer entries at layerTableOffset
+ *  - the layers, each 64-byte aligned and followed by at least three zero bytes
+ *
+ * The header, the layer table and every layer carry a checksum. Open() validates all of
+ * them and the tile values before the map is used, so a corrupt file fails at load time.
+ * A streamed level leaves the tile layer to the reader: Open() doesn't touch it, and the
+ * reader checks the values of each part it reads with AreTilesValid().
+ * Unknown layer types are skipped, newer versions are rejected.
+ */
+class MapFile
+{
+public:
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    enum LayerType : std::uint32_t
+    {
+        /**
+         * @brief Row-major Map::MapType values, one byte per tile. Required.
+         */
+        TILES = 1,
+
+        /**
+         * @brief Free-form UTF-8 text, e.g. "name=E1M1". Optional.
+         */
+        METADATA = 2
+    };
+
+    struct MapFileHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t headerSize;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t layerCount;
+        std::uint64_t layerTableOffset;
+        std::uint64_t layerTableChecksum;
+
+        /**
+         * @brief The checksum of all header bytes before this member.
+         */
+        std::uint64_t headerChecksum;
+        std::uint8_t reserved[16];
+    };
+
+    struct MapFileLayer
+    {
+        std::uint32_t type;
+        std::uint32_t reserved;
+        std::uint64_t offset;
+        std::uint64_t size;
+        std::uint64_t checksum;
+    };
+
+    //-------------------------------------------------
+    // Constants
+    //-------------------------------------------------
+
+    static constexpr char MAGIC[4]{ 'R', 'C', 'M', 'P' };
+    static constexpr std::uint32_t VERSION{ 1 };
+
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    MapFile() = default;
+
+    MapFile(const MapFile& t_other) = delete;
+    MapFile(MapFile&& t_other) noexcept = delete;
+    MapFile& operator=(const MapFile& t_other) = delete;
+    MapFile& operator=(MapFile&& t_other) noexcept = delete;
+
+    ~MapFile() noexcept;
+
+    //-------------------------------------------------
+    // Logic
+    //-------------------------------------------------
+
+    /**
+     * @brief Maps a binary level into memory and validates it.
+     *
+     * @param t_path The path to the level file.
+     * @param t_checkTiles If false, the checksum and the values of the tile layer aren't checked,
+     *                     so none of its pages are read; the caller checks the tiles it reads.
+     *
+     * @return True if the file is a valid level, otherwise false.
+     */
+    bool Open(const std::string& t_path, bool t_checkTiles = true);
+
+    /**
+     * @brief Checks the magic bytes of a file.
+     *
+     * @param t_path The path to the level file.
+     *
+     * @return True if the file starts like a binary level, otherwise false.
+     */
+    [[nodiscard]] static bool IsMapFile(const std::string& t_path);
+
+    /**
+     * @brief Writes a binary level.
+     *
+     * @param t_path The path to the file to write.
+     * @param t_width The width of the map (number of tiles).
+     * @param t_height The height of the map (number of tiles).
+     * @param t_tiles Row-major Map::MapType values, at least t_width * t_height entries.
+     * @param t_metadata Optional text stored in a METADATA layer.
+     *
+     * @return True if the file was written, otherwise false.
+     */
+    static bool Write(
+        const std::string& t_path,
+        int t_width, int t_height,
+        std::span<const std::uint8_t> t_tiles,
+        std::string_view t_metadata = {}
+    );
+
+    /**
+     * @brief The checksum used by the format, a 64-bit multiply-xor hash over 8-byte words.
+     */
+    [[nodiscard]] static std::uint64_t Checksum(const void* t_data, std::size_t t_size);
+
+    /**
+     * @brief Checks that tiles only hold known Map::MapType values.
+     */
+    [[nodiscard]] static bool AreTilesValid(const std::uint8_t* t_tiles, std::size_t t_count);
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    [[nodiscard]] int GetWidth() const;
+    [[nodiscard]] int GetHeight() const;
+
+    /**
+     * @brief The tile layer inside the mapping, followed by at least three readable bytes.
+     */
+    [[nodiscard]] const std::uint8_t* GetTiles() const;
+
+    /**
+     * @brief The METADATA layer, or an empty view.
+     */
+    [[nodiscard]] std::string_view GetMetadata() const;
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    int m_fd{ -1 };
+    const std::uint8_t* m_data{ nullptr };
+    std::size_t m_size{ 0 };
+
+    int m_width{ 0 };
+    int m_height{ 0 };
+    const std::uint8_t* m_tiles{ nullptr };
+    std::string_view m_metadata;
+
+    //-------------------------------------------------
+    // Helper
+    //-------------------------------------------------
+
+    /**
+     * @brief Checks the header, the layer table, the checksums and the tile values.
+     *
+     * @param t_path The path, used for the error messages.
+     * @param t_checkTiles If false, the checksum and the values of the tile layer are skipped.
+     */
+    bool Validate(const std::string& t_path, bool t_checkTiles);
+
+    void Close();
+};
+
+//-------------------------------------------------
+// Text levels
+//-------------------------------------------------
+
+/**
+ * @brief Parses a text level.
+ *
+ * Each line is a row of tiles; '#' and '1' are walls, every other character is empty.
+ * The width is the length of the longest row, shorter rows are filled with empty tiles.
+ *
+ * @param t_text The content of the level file.
+ * @param t_width Receives the width of the map.
+ * @param t_height Receives the height of the map.
+ * @param t_tiles Receives the row-major tiles.
+ *
+ * @return False if the text contains no tiles.
+ */
+bool parse_text_map(std::string_view t_text, int& t_width, int& t_height, std::vector<std::uint8_t>& t_tiles);
@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include "OccupancyGrid.h"
+#include "RayTrace.h"
+#include "Utils.h"
+#include "Assert.h"
+#include "Log.h"
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void OccupancyGrid::Build(const std::uint8_t* t_tiles, const int t_width, const int t_height)
+{
+    m_width = t_width;
+    m_height = t_height;
+    m_blocksPerRow = (t_width + BLOCK_MASK) >> BLOCK_SHIFT;
+    m_blockRows = (t_height + BLOCK_MASK) >> BLOCK_SHIFT;
+    m_chunks.clear();
+    m_freeChunks.clear();
+
+    m_blocks.resize(static_cast<std::size_t>(m_blocksPerRow) * m_blockRows);
+    m_blocks.shrink_to_fit();
+    EncodeBlocks(t_tiles, t_width, t_height, 0, 0, m_blocksPerRow, m_blockRows, m_blocks.data());
+
+    BuildPyramid();
+}
+
+void OccupancyGrid::Fill(const int t_width, const int t_height, const int t_chunkSize, const int t_maxChunks)
+{
+    FPS_ASSERT(std::has_single_bit(static_cast<unsigned>(t_chunkSize)) && t_chunkSize >= BLOCK_SIZE, "Invalid chunk size.");
+
+    m_width = t_width;
+    m_height = t_height;
+    m_blocksPerRow = (t_width + BLOCK_MASK) >> BLOCK_SHIFT;
+    m_blockRows = (t_height + BLOCK_MASK) >> BLOCK_SHIFT;
+    m_chunkShift = std::countr_zero(static_cast<unsigned>(t_chunkSize));
+    m_chunksPerRow = (t_width + t_chunkSize - 1) >> m_chunkShift;
+    m_blocksPerChunk = t_chunkSize >> BLOCK_SHIFT;
+
+    const auto chunkCount{ m_chunksPerRow * ((t_height + t_chunkSize - 1) >> m_chunkShift) };
+    const auto poolChunks{ std::clamp(t_maxChunks, 1, chunkCount) };
+    const auto wordsPerChunk{ static_cast<std::size_t>(m_blocksPerChunk) * m_blocksPerChunk };
+
+    // the first chunk of the pool is the walls every chunk that isn't resident maps to
+    m_blocks.assign(wordsPerChunk * (poolChunks + 1), ~std::uint64_t{ 0 });
+    m_blocks.shrink_to_fit();
+    m_chunks.assign(chunkCount, 0);
+    m_freeChunks.resize(poolChunks);
+    for (auto i{ 0 }; i < poolChunks; ++i)
+    {
+        m_freeChunks[i] = static_cast<std::uint32_t>(wordsPerChunk * (poolChunks - i));
+    }
+
+    BuildPyramid();
+}
+
+void OccupancyGrid::SetChunk(const int t_chunk, const std::uint64_t* t_blocks)
+{
+    FPS_ASSERT(!m_chunks.empty(), "Only a streamed grid has chunks.");
+
+    const auto wordsPerChunk{ static_cast<std::size_t>(m_blocksPerChunk) * m_blocksPerChunk };
+    auto& offset{ m_chunks[t_chunk] };
+    if (t_blocks)
+    {
+        if (offset == 0)
+        {
+            if (m_freeChunks.empty())
+            {
+                FPS_LOG_ERROR("[OccupancyGrid::SetChunk()] No room for chunk {}, it stays all walls.", t_chunk);
+                return;
+            }
+
+            offset = m_freeChunks.back();
+            m_freeChunks.pop_back();
+        }
+
+        std::copy_n(t_blocks, wordsPerChunk, &m_blocks[offset]);
+    }
+    else if (offset != 0)
+    {
+        m_freeChunks.push_back(offset);
+        offset = 0;
+    }
+
+    const auto blockX{ (t_chunk % m_chunksPerRow) * m_blocksPerChunk };
+    const auto blockY{ (t_chunk / m_chunksPerRow) * m_blocksPerChunk };
+    UpdatePyramid(
+        blockX, blockY,
+        std::min(m_blocksPerChunk, m_blocksPerRow - blockX), std::min(m_blocksPerChunk, m_blockRows - blockY)
+    );
+}
+
+void OccupancyGrid::SetWall(const int t_mapX, const int t_mapY, const bool t_wall)
+{
+    FPS_ASSERT(m_chunks.empty(), "A streamed grid only changes chunk by chunk.");
+
+    auto& block{ m_blocks[BlockIndex(t_mapX, t_mapY, m_blocksPerRow)] };
+    const auto bit{ std::uint64_t{ 1 } << BitIndex(t_mapX, t_mapY) };
+    block = t_wall ? block | bit : block & ~bit;
+
+    UpdatePyramid(t_mapX >> BLOCK_SHIFT, t_mapY >> BLOCK_SHIFT, 1, 1);
+}
+
+bool OccupancyGrid::IsWall(const int t_mapX, const int t_mapY) const
+{
+    if (is_position_not_on_map(t_mapX, t_mapY, m_width, m_height))
+    {
+        return true;
+    }
+
+    return (GetBlock(t_mapX >> BLOCK_SHIFT, t_mapY >> BLOCK_SHIFT) >> BitIndex(t_mapX, t_mapY)) & 1;
+}
+
+int OccupancyGrid::GetEmptyLevel(const int t_mapX, const int t_mapY) const
+{
+    auto level{ 0 };
+    while (level < GetLevelCount() && IsSquareEmpty(level + 1, t_mapX, t_mapY))
+    {
+        ++level;
+    }
+
+    return level;
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+int OccupancyGrid::GetWidth() const
+{
+    return m_width;
+}
+
+int OccupancyGrid::GetHeight() const
+{
+    return m_height;
+}
+
+std::size_t OccupancyGrid::GetBlockBytes() const
+{
+    return m_blocks.capacity() * sizeof(std::uint64_t) + m_chunks.capacity() * sizeof(std::uint32_t);
+}
+
+int OccupancyGrid::GetLevelCount() const
+{
+    return static_cast<int>(m_levels.size());
+}
+
+TraceGrid OccupancyGrid::GetTraceGrid(const float t_tileSize) const
+{
+    TraceGrid grid{ m_blocks.data(), m_blocksPerRow, m_width, m_height, t_tileSize, this };
+    if (!m_chunks.empty())
+    {
+        grid.blocksPerRow = m_blocksPerChunk;
+        grid.chunks = m_chunks.data();
+        grid.chunkShift = m_chunkShift;
+        grid.chunksPerRow = m_chunksPerRow;
+    }
+
+    return grid;
+}
+
+//-------------------------------------------------
+// Layout
+//-------------------------------------------------
+
+void OccupancyGrid::EncodeBlocks(
+    const std::uint8_t* t_tiles, const int t_width, const int t_height,
+    const int t_blockX, const int t_blockY, const int t_blocksWide, const int t_blocksHigh,
+    std::uint64_t* t_blocks
+)
+{
+    // everything outside the map stays a wall
+    std::fill_n(t_blocks, static_cast<std::size_t>(t_blocksWide) * t_blocksHigh, ~std::uint64_t{ 0 });
+
+    const auto firstY{ t_blockY << BLOCK_SHIFT };
+    const auto endY{ std::min(t_height, (t_blockY + t_blocksHigh) << BLOCK_SHIFT) };
+    const auto endBlockX{ std::min(t_blocksWide, ((t_width + BLOCK_MASK) >> BLOCK_SHIFT) - t_blockX) };
+
+    for (auto y{ firstY }; y < endY; ++y)
+    {
+        const auto* row{ t_tiles + static_cast<std::size_t>(y) * t_width };
+        auto* blocks{ t_blocks + static_cast<std::size_t>((y >> BLOCK_SHIFT) - t_blockY) * t_blocksWide };
+        const auto shift{ (y & BLOCK_MASK) << BLOCK_SHIFT };
+
+        for (auto blockX{ 0 }; blockX < endBlockX; ++blockX)
+        {
+            const auto x{ (t_blockX + blockX) << BLOCK_SHIFT };
+            std::uint64_t bits;
+            if (t_width - x >= BLOCK_SIZE)
+            {
+                // tiles are 0 or 1: move the low bit of each of the 8 bytes into the top byte
+                std::uint64_t bytes;
+                std::memcpy(&bytes, row + x, sizeof(bytes));
+                bits = ((bytes & 0x0101010101010101ull) * 0x0102040810204080ull) >> 56;
+            }
+            else
+            {
+                bits = 0xff;
+                for (auto i{ 0 }; i < t_width - x; ++i)
+                {
+                    if (row[x + i] == 0)
+                    {
+                        bits &= ~(std::uint64_t{ 1 } << i);
+                    }
+                }
+            }
+
+            blocks[blockX] = (blocks[blockX] & ~(std::uint64_t{ 0xff } << shift)) | (bits << shift);
+        }
+    }
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+void OccupancyGrid::BuildPyramid()
+{
+    m_levels.clear();
+    m_squares.clear();
+
+    // level 0 are the blocks themselves; stop once a single square covers the whole map
+    auto childrenPerRow{ m_blocksPerRow };
+    auto childRows{ m_blockRows };
+    for (auto level{ 1 }; childrenPerRow > 1 || childRows > 1; ++level)
+    {
+        const auto squaresPerRow{ (childrenPerRow + 1) / 2 };
+        const auto rows{ (childRows + 1) / 2 };
+        m_levels.push_back({ static_cast<int>(m_squares.size()), squaresPerRow, rows });
+        m_squares.resize(m_squares.size() + static_cast<std::size_t>(squaresPerRow) * rows);
+
+        for (auto y{ 0 }; y < rows; ++y)
+        {
+            for (auto x{ 0 }; x < squaresPerRow; ++x)
+            {
+                UpdateSquare(level, x, y);
+            }
+        }
+
+        childrenPerRow = squaresPerRow;
+        childRows = rows;
+    }
+}
+
+bool OccupancyGrid::IsCellEmpty(const int t_level, const int t_x, const int t_y) const
+{
+    if (t_level == 0)
+    {
+        if (t_x >= m_blocksPerRow || t_y >= m_blockRows)
+        {
+            return false;
+        }
+
+        return GetBlock(t_x, t_y) == 0;
+    }
+
+    const auto& level{ m_levels[t_level - 1] };
+    if (t_x >= level.squaresPerRow || t_y >= level.rows)
+    {
+        return false;
+    }
+
+    return m_squares[level.offset + t_y * level.squaresPerRow + t_x] == 0;
+}
+
+std::uint64_t OccupancyGrid::GetBlock(const int t_blockX, const int t_blockY) const
+{
+    if (m_chunks.empty())
+    {
+        return m_blocks[static_cast<std::size_t>(t_blockY) * m_blocksPerRow + t_blockX];
+    }
+
+    const auto shift{ m_chunkShift - BLOCK_SHIFT };
+    const auto mask{ m_blocksPerChunk - 1 };
+    const auto chunk{ (t_blockY >> shift) * m_chunksPerRow + (t_blockX >> shift) };
+
+    return m_blocks[m_chunks[chunk] + (t_blockY & mask) * m_blocksPerChunk + (t_blockX & mask)];
+}
+
+void OccupancyGrid::UpdateSquare(const int t_level, const int t_x, const int t_y)
+{
+    const auto child{ t_level - 1 };
+    const auto empty{
+        IsCellEmpty(child, 2 * t_x, 2 * t_y) && IsCellEmpty(child, 2 * t_x + 1, 2 * t_y) &&
+        IsCellEmpty(child, 2 * t_x, 2 * t_y + 1) && IsCellEmpty(child, 2 * t_x + 1, 2 * t_y + 1)
+    };
+
+    const auto& level{ m_levels[t_level - 1] };
+    m_squares[level.offset + t_y * level.squaresPerRow + t_x] = empty ? 0 : 1;
+}
+
+void OccupancyGrid::UpdatePyramid(const int t_blockX, const int t_blockY, const int t_blocksWide, const int t_blocksHigh)
+{
+    for (auto level{ 1 }; level <= GetLevelCount(); ++level)
+    {
+        for (auto y{ t_blockY >> level }; y <= (t_blockY + t_blocksHigh - 1) >> level; ++y)
+        {
+            for (auto x{ t_blockX >> level }; x <= (t_blockX + t_blocksWide - 1) >> level; ++x)
+            {
+                UpdateSquare(level, x, y);
+            }
+        }
+    }
+}
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+//-------------------------------------------------
+// Forward declarations
+//-------------------------------------------------
+
+struct TraceGrid;
+
+//-------------------------------------------------
+// OccupancyGrid
+//-------------------------------------------------
+
+/**
+ * @brief One bit per tile, set for walls, packed in blocks of 8x8 tiles.
+ *
+ * Each block is a single 64-bit word (bit (y % 8) * 8 + x % 8), stored row-major by block.
+ * The bits take an eighth of the memory of the tile bytes, so a ray touches fewer cache
+ * lines, and a block without walls is a zero word that can be skipped in one test.
+ * Bits of a block that lie outside the map are set, so an edge block is never empty.
+ *
+ * On top of the blocks sits a pyramid of coarser levels: level l has one byte per square
+ * of (8 << l) x (8 << l) tiles, zero if the square has no walls. A ray in open space can
+ * cross a whole empty square at once. Squares reaching past the map are never empty.
+ *
+ * A streamed grid (see Fill()) stores its blocks per chunk instead: a table maps each chunk
+ * to its blocks in a pool with room for a fixed number of chunks, and every chunk that isn't
+ * resident maps to one shared chunk of walls. The blocks then take memory for the resident
+ * chunks only; the table and the pyramid stay sized for the whole map.
+ */
+class OccupancyGrid
+{
+public:
+    //-------------------------------------------------
+    // Constants
+    //-------------------------------------------------
+
+    static constexpr auto BLOCK_SHIFT{ 3 };
+    static constexpr auto BLOCK_SIZE{ 1 << BLOCK_SHIFT };
+    static constexpr auto BLOCK_MASK{ BLOCK_SIZE - 1 };
+
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    OccupancyGrid() = default;
+
+    OccupancyGrid(const OccupancyGrid& t_other) = delete;
+    OccupancyGrid(OccupancyGrid&& t_other) noexcept = delete;
+    OccupancyGrid& operator=(const OccupancyGrid& t_other) = delete;
+    OccupancyGrid& operator=(OccupancyGrid&& t_other) noexcept = delete;
+
+    ~OccupancyGrid() noexcept = default;
+
+    //-------------------------------------------------
+    // Logic
+    //-------------------------------------------------
+
+    /**
+     * @brief Rebuilds the bits from a tile layout.
+     *
+     * @param t_tiles Row-major Map::MapType values, t_width * t_height entries.
+     * @param t_width The width of the map (number of tiles).
+     * @param t_height The height of the map (number of tiles).
+     */
+    void Build(const std::uint8_t* t_tiles, int t_width, int t_height);
+
+    /**
+     * @brief Sizes the grid for a streamed map whose tiles aren't loaded yet; every tile is a wall.
+     *
+     * @param t_width The width of the map (number of tiles).
+     * @param t_height The height of the map (number of tiles).
+     * @param t_chunkSize The number of tiles per chunk side, a power of two of at least BLOCK_SIZE.
+     * @param t_maxChunks The most chunks that hold blocks at once.
+     */
+    void Fill(int t_width, int t_height, int t_chunkSize, int t_maxChunks);
+
+    /**
+     * @brief Gives a chunk of a streamed grid its blocks, or turns it back into walls, and
+     *        updates the pyramid squares above it.
+     *
+     * @param t_chunk The row-major index of the chunk.
+     * @param t_blocks The chunk's (chunk size / 8)^2 row-major words from EncodeBlocks();
+     *                 null turns the chunk into walls and frees its blocks.
+     */
+    void SetChunk(int t_chunk, const std::uint64_t* t_blocks);
+
+    /**
+     * @brief Sets or clears the wall bit of a single tile and updates the pyramid squares above it.
+     *
+     * @param t_mapX The x-coordinate on the map, must be on the map.
+     * @param t_mapY The y-coordinate on the map, must be on the map.
+     * @param t_wall True for a wall, false for an empty tile.
+     */
+    void SetWall(int t_mapX, int t_mapY, bool t_wall);
+
+    /**
+     * @brief Checks if a wall exists at the given map coordinates.
+     *
+     * @return True if there is a wall or the position is outside the map, otherwise false.
+     */
+    [[nodiscard]] bool IsWall(int t_mapX, int t_mapY) const;
+
+    /**
+     * @brief The highest pyramid level whose square around a map position has no walls.
+     *
+     * @param t_mapX The x-coordinate on the map, must be on the map.
+     * @param t_mapY The y-coordinate on the map, must be on the map.
+     *
+     * @return 0 if only the position's block is known to be empty, up to GetLevelCount().
+     */
+    [[nodiscard]] int GetEmptyLevel(int t_mapX, int t_mapY) const;
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    [[nodiscard]] int GetWidth() const;
+    [[nodiscard]] int GetHeight() const;
+
+    /**
+     * @brief The memory held by the blocks in bytes; bounded by the chunk limit in a streamed grid.
+     */
+    [[nodiscard]] std::size_t GetBlockBytes() const;
+
+    /**
+     * @brief The number of pyramid levels above the blocks; level 1 to GetLevelCount() are valid.
+     */
+    [[nodiscard]] int GetLevelCount() const;
+
+    /**
+     * @brief A view of the blocks for the ray traversal.
+     *
+     * @param t_tileSize The size of a tile in screen units.
+     */
+    [[nodiscard]] TraceGrid GetTraceGrid(float t_tileSize) const;
+
+    //-------------------------------------------------
+    // Layout
+    //-------------------------------------------------
+
+    /**
+     * @brief Packs a rectangle of blocks of a tile layout into wall bits.
+     *
+     * @param t_tiles Row-major Map::MapType values, t_width * t_height entries.
+     * @param t_width The width of the map (number of tiles).
+     * @param t_height The height of the map (number of tiles).
+     * @param t_blockX The first block column.
+     * @param t_blockY The first block row.
+     * @param t_blocksWide The number of block columns.
+     * @param t_blocksHigh The number of block rows.
+     * @param t_blocks Receives t_blocksWide * t_blocksHigh row-major words; bits outside the map are set.
+     */
+    static void EncodeBlocks(
+        const std::uint8_t* t_tiles, int t_width, int t_height,
+        int t_blockX, int t_blockY, int t_blocksWide, int t_blocksHigh,
+        std::uint64_t* t_blocks
+    );
+
+    /**
+     * @brief The index of the block containing a map position.
+     */
+    [[nodiscard]] static constexpr int BlockIndex(const int t_mapX, const int t_mapY, const int t_blocksPerRow)
+    {
+        return (t_mapY >> BLOCK_SHIFT) * t_blocksPerRow + (t_mapX >> BLOCK_SHIFT);
+    }
+
+    /**
+     * @brief The bit of a map position inside its block.
+     */
+    [[nodiscard]] static constexpr int BitIndex(const int t_mapX, const int t_mapY)
+    {
+        return ((t_mapY & BLOCK_MASK) << BLOCK_SHIFT) | (t_mapX & BLOCK_MASK);
+    }
+
+    /**
+     * @brief Checks if the pyramid square of a level containing a map position has no walls.
+     *
+     * @param t_level The level, 1 to GetLevelCount(); a square has (8 << t_level) tiles per side.
+     * @param t_mapX The x-coordinate on the map, must be on the map.
+     * @param t_mapY The y-coordinate on the map, must be on the map.
+     */
+    [[nodiscard]] bool IsSquareEmpty(const int t_level, const int t_mapX, const int t_mapY) const
+    {
+        const auto& level{ m_levels[t_level - 1] };
+        const auto shift{ BLOCK_SHIFT + t_level };
+
+        return m_squares[level.offset + (t_mapY >> shift) * level.squaresPerRow + (t_mapX >> shift)] == 0;
+    }
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    int m_width{ 0 };
+    int m_height{ 0 };
+    int m_blocksPerRow{ 0 };
+    int m_blockRows{ 0 };
+
+    /**
+     * @brief Row-major over the whole map, or the chunk pool of a streamed grid.
+     */
+    std::vector<std::uint64_t> m_blocks;
+
+    /**
+     * @brief The chunks of a streamed grid: the offset of each chunk's blocks in m_blocks,
+     *        0 for the shared chunk of walls; empty if the grid isn't streamed.
+     */
+    std::vector<std::uint32_t> m_chunks;
+
+    /**
+     * @brief The offsets of the pool's unused chunks.
+     */
+    std::vector<std::uint32_t> m_freeChunks;
+
+    int m_chunkShift{ 0 };
+    int m_chunksPerRow{ 0 };
+    int m_blocksPerChunk{ 0 };
+
+    /**
+     * @brief Where a pyramid level starts in m_squares and its row length.
+     */
+    struct Level
+    {
+        int offset;
+        int squaresPerRow;
+        int rows;
+    };
+
+    std::vector<Level> m_levels;
+
+    /**
+     * @brief All pyramid levels, finest first; nonzero if the square has a wall.
+     */
+    std::vector<std::uint8_t> m_squares;
+
+    //-------------------------------------------------
+    // Helper
+    //-------------------------------------------------
+
+    /**
+     * @brief Builds the pyramid levels from the blocks.
+     */
+    void BuildPyramid();
+
+    /**
+     * @brief The block at a block position on the map.
+     */
+    [[nodiscard]] std::uint64_t GetBlock(int t_blockX, int t_blockY) const;
+
+    /**
+     * @brief Checks if a block (level 0) or a pyramid square has no walls; outside the level counts as walls.
+     */
+    [[nodiscard]] bool IsCellEmpty(int t_level, int t_x, int t_y) const;
+
+    /**
+     * @brief Recomputes a pyramid square of level 1 or higher from its four children.
+     */
+    void UpdateSquare(int t_level, int t_x, int t_y);
+
+    /**
+     * @brief Recomputes the pyramid squares above a rectangle of blocks.
+     */
+    void UpdatePyramid(int t_blockX, int t_blockY, int t_blocksWide, int t_blocksHigh);
+};
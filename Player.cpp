@@ -1,33 +1,43 @@
+#include <cmath>
 #include "Player.h"
-#include "Game.h"
+#include "Map.h"
 #include "Utils.h"
+#include "FrameArena.h"
+#include "HudText.h"
+#include "JobSystem.h"
+#include "RayTrace.h"
+#include "Assert.h"
+#include "Profiler.h"
 
 //-------------------------------------------------
 // Ctors. / Dtor.
 //-------------------------------------------------
 
-Player::Player()
+Player::Player(const Config& t_config, const Map& t_map, const bool t_castsRays)
+    : m_config{ t_config }
+    , m_map{ t_map }
 {
-    SetPositionsByMapXY(
-    Game::INI.Get<int>("player", "start_x"),
-    Game::INI.Get<int>("player", "start_y")
-    );
+    SetPositionsByMapXY(m_config.player.startX, m_config.player.startY);
+    if (t_castsRays)
+    {
+        rays.Resize(m_config.player.nrOfRays);
+    }
 }
 
 //-------------------------------------------------
 // Logic
 //-------------------------------------------------
 
-void Player::HandleInput(const float t_dt, const olc::PixelGameEngine* t_pge)
+void Player::HandleInput(const float t_dt, const InputState& t_input)
 {
-    const auto turnSpeed{ Game::INI.Get<float>("player", "turn_speed") };
-    const auto moveSpeed{ Game::INI.Get<float>("player", "move_speed") };
+    const auto turnSpeed{ m_config.player.turnSpeed };
+    const auto moveSpeed{ m_config.player.moveSpeed };
 
-    if (t_pge->GetKey(olc::Key::LEFT).bHeld)
+    if (t_input.turnLeft)
     {
         radians = clamp_radians(radians - t_dt * turnSpeed);
     }
-    if (t_pge->GetKey(olc::Key::RIGHT).bHeld)
+    if (t_input.turnRight)
     {
         radians = clamp_radians(radians + t_dt * turnSpeed);
     }
@@ -37,53 +47,131 @@ void Player::HandleInput(const float t_dt, const olc::PixelGameEngine* t_pge)
     auto screenY{ m_screenPosition.y };
 
     // calc new screen position
-    if (t_pge->GetKey(olc::Key::UP).bHeld)
+    if (t_input.moveForward)
     {
         adjust_screen_position_by_angle(screenX, screenY, radians, t_dt, moveSpeed, true);
     }
-    if (t_pge->GetKey(olc::Key::DOWN).bHeld)
+    if (t_input.moveBackward)
     {
         adjust_screen_position_by_angle(screenX, screenY, radians, t_dt, moveSpeed, false);
     }
 
     // set new player map and screen positions if there is no wall
-    if (!Map::IsMapTypeAtScreenPosition(screenX, screenY, Map::WALL))
+    if (!m_map.IsMapTypeAtScreenPosition(screenX, screenY, m_config.render.tileSize, Map::WALL))
     {
         SetPositionsByScreenXY(screenX, screenY);
     }
 }
 
-void Player::CastRays()
+bool Player::CastRays(JobSystem& t_jobs)
 {
-    const auto nrOfRays{ Game::INI.Get<int>("player", "nr_of_rays") };
-    const auto fovDeg{ Game::INI.Get<float>("player", "fov") };
-    const auto fovRad{ fovDeg / 180.0f * static_cast<float>(M_PI) };
-    const auto startRad{ radians - fovRad / 2.0f };
-    const auto radPerRay{ fovRad / static_cast<float>(nrOfRays) };
-
-    clear_vector(rays);
-
-    for (auto i{ 0 }; i < nrOfRays; ++i)
+    const auto nrOfRays{ m_config.player.nrOfRays };
+    const auto tableChanged{ m_cameraTable.Update(m_config.player.fovRad, nrOfRays) };
+    const auto angleOffsets{ m_cameraTable.GetAngleOffsets() };
+    const auto rayRadians{ rays.GetRadians() };
+    const auto mapVersion{ m_map.GetVersion() };
+
+    FPS_ASSERT(rays.Size() == nrOfRays, "The ray buffer doesn't match the number of rays.");
+
+    // the view turns in whole columns, so a turn moves the columns by exactly its number of steps
+    const auto radPerRay{ m_config.player.fovRad / static_cast<float>(nrOfRays) };
+    const auto column{ static_cast<int>(std::lround(radians / radPerRay)) };
+    const auto castRadians{ static_cast<float>(column) * radPerRay };
+
+    // the columns to cast; all of them unless the last results still fit
+    auto begin{ 0 };
+    auto end{ nrOfRays };
+    if (m_castKey && !tableChanged && m_castKey->screenPosition == m_screenPosition && m_castKey->mapVersion == mapVersion)
     {
-        const auto radians{ clamp_radians(startRad + static_cast<float>(i) * radPerRay) };
-        Ray vRay{ m_screenPosition, radians, Ray::VERTICAL };
-        Ray hRay{ m_screenPosition, radians, Ray::HORIZONTAL };
-        GetVerticalIntersection(vRay);
-        GetHorizontalIntersection(hRay);
-        rays.push_back(vRay.length < hRay.length ? vRay : hRay);
+        if (m_castKey->column == column)
+        {
+            return false;
+        }
+
+        // column i of a view turned by k columns looks where column i + k looked before;
+        // a full turn isn't a whole number of columns, so a turn across 0 recasts everything
+        const auto shift{ column - m_castKey->column };
+        const auto acrossZero{ static_cast<float>(std::abs(shift)) * radPerRay > static_cast<float>(M_PI) };
+        if (std::abs(shift) < nrOfRays && !acrossZero)
+        {
+            rays.Shift(shift);
+
+            // the kept columns only get their new angles
+            const auto keptBegin{ shift > 0 ? 0 : -shift };
+            const auto keptEnd{ shift > 0 ? nrOfRays - shift : nrOfRays };
+            for (auto i{ keptBegin }; i < keptEnd; ++i)
+            {
+                rayRadians[i] = wrap_radians(castRadians + angleOffsets[i]);
+            }
+
+            begin = shift > 0 ? keptEnd : 0;
+            end = shift > 0 ? nrOfRays : keptBegin;
+        }
     }
+
+    m_castKey = CastKey{ m_screenPosition, column, mapVersion };
+
+    // the only trigonometry of the frame
+    const auto cosRad{ cosf(castRadians) };
+    const auto sinRad{ sinf(castRadians) };
+
+    const auto lengths{ rays.GetLengths() };
+    const auto hitX{ rays.GetHitX() };
+    const auto hitY{ rays.GetHitY() };
+    const auto types{ rays.GetTypes() };
+
+    const auto grid{ m_map.GetTraceGrid() };
+    // the SIMD kernel only jumps from empty blocks, which misses most jumps of the distance field
+    const auto simd{ m_config.player.simd && m_config.player.castMode == CastMode::GRID };
+
+    // neighbouring columns share the origin, so they are traced in packets
+    auto castChunk{ [&](const int t_begin, const int t_end) {
+        RayPacket packet{};
+        for (auto first{ t_begin }; first < t_end; first += RayPacket::SIZE)
+        {
+            const auto count{ std::min(RayPacket::SIZE, t_end - first) };
+            m_cameraTable.Rotate(cosRad, sinRad, packet.dirX, packet.dirY, first, first + count);
+            for (auto lane{ 0 }; lane < count; ++lane)
+            {
+                rayRadians[first + lane] = wrap_radians(castRadians + angleOffsets[first + lane]);
+            }
+
+            trace_ray_packet(grid, m_screenPosition.x, m_screenPosition.y, packet, count, simd);
+
+            for (auto lane{ 0 }; lane < count; ++lane)
+            {
+                lengths[first + lane] = packet.length[lane];
+                hitX[first + lane] = packet.hitX[lane];
+                hitY[first + lane] = packet.hitY[lane];
+                types[first + lane] = static_cast<Ray::RayType>(packet.type[lane]);
+            }
+        }
+    } };
+
+    auto castColumns{ [&](const int t_begin, const int t_end) {
+        castChunk(begin + t_begin, begin + t_end);
+    } };
+
+    t_jobs.ParallelFor(end - begin, m_config.threads.chunkSize, castColumns, "CastRays chunk");
+
+    return true;
+}
+
+void Player::InvalidateRays()
+{
+    m_castKey.reset();
 }
 
-void Player::RenderPlayer(olc::PixelGameEngine* t_pge, const float t_xOffset, const float t_yOffset, const float t_scale) const
+void Player::RenderPlayer(olc::PixelGameEngine* t_pge, const Map::MiniMapView& t_view) const
 {
-    const auto startX{ t_xOffset + m_screenPosition.x * t_scale };
-    const auto startY{ t_yOffset + m_screenPosition.y * t_scale };
+    const auto startX{ t_view.xOffset + m_screenPosition.x * t_view.scale };
+    const auto startY{ t_view.yOffset + m_screenPosition.y * t_view.scale };
     const auto startXInt{ static_cast<int>(startX) };
     const auto startYInt{ static_cast<int>(startY) };
 
     t_pge->FillCircle(startXInt, startYInt, 2, olc::DARK_GREEN);
 
-    const auto lineLength{ Game::INI.Get<float>("player", "line_length") };
+    const auto lineLength{ m_config.player.lineLength };
 
     const auto endPositionX{ startX + lineLength * cosf(radians) };
     const auto endPositionY{ startY + lineLength * sinf(radians) };
@@ -91,20 +179,118 @@ void Player::RenderPlayer(olc::PixelGameEngine* t_pge, const float t_xOffset, co
     t_pge->DrawLine(startXInt, startYInt, static_cast<int>(endPositionX), static_cast<int>(endPositionY), olc::DARK_GREEN);
 }
 
-void Player::RenderRays(olc::PixelGameEngine* t_pge, const float t_xOffset, const float t_yOffset, const float t_scale) const
+void Player::RenderRays(olc::PixelGameEngine* t_pge, const Map::MiniMapView& t_view, FrameArena& t_arena) const
+{
+    const auto hitX{ rays.GetHitX() };
+    const auto hitY{ rays.GetHitY() };
+
+    const auto sx{ t_view.xOffset + m_screenPosition.x * t_view.scale };
+    const auto sy{ t_view.yOffset + m_screenPosition.y * t_view.scale };
+
+    // the window of the mini-map on the screen
+    const auto tileScale{ m_config.render.tileSize * t_view.scale };
+    const auto minX{ t_view.xOffset + static_cast<float>(t_view.firstX) * tileScale };
+    const auto minY{ t_view.yOffset + static_cast<float>(t_view.firstY) * tileScale };
+    const auto maxX{ t_view.xOffset + static_cast<float>(t_view.endX) * tileScale };
+    const auto maxY{ t_view.yOffset + static_cast<float>(t_view.endY) * tileScale };
+
+    // the hit markers are drawn after all lines, so the next ray's line doesn't cut through them
+    FrameVector<olc::vi2d> hits{ FrameAllocator<olc::vi2d>{ t_arena } };
+    hits.reserve(rays.Size());
+
+    for (auto i{ 0 }; i < rays.Size(); ++i)
+    {
+        // the ray ends at its hit position or where it leaves the window
+        const auto dx{ t_view.xOffset + hitX[i] * t_view.scale - sx };
+        const auto dy{ t_view.yOffset + hitY[i] * t_view.scale - sy };
+
+        const auto tx{ dx > 0.0f ? (maxX - sx) / dx : dx < 0.0f ? (minX - sx) / dx : 1.0f };
+        const auto ty{ dy > 0.0f ? (maxY - sy) / dy : dy < 0.0f ? (minY - sy) / dy : 1.0f };
+        const auto t{ std::min({ 1.0f, tx, ty }) };
+
+        const auto shx{ sx + dx * t };
+        const auto shy{ sy + dy * t };
+
+        t_pge->DrawLine(
+            static_cast<int>(sx),
+            static_cast<int>(sy),
+            static_cast<int>(shx),
+            static_cast<int>(shy),
+            olc::RED
+        );
+
+        if (t == 1.0f)
+        {
+            hits.emplace_back(static_cast<int>(shx), static_cast<int>(shy));
+        }
+    }
+
+    for (const auto& hit : hits)
+    {
+        t_pge->DrawCircle(hit, 1, olc::GREEN);
+    }
+}
+
+void Player::RenderDebugInfo(olc::PixelGameEngine* t_pge, HudText& t_hud, [[maybe_unused]] const Profiler& t_profiler) const
 {
-    for (const auto& ray : rays)
+    auto* target{ t_pge->GetDrawTarget() };
+
+    t_hud.Draw(target, 500, 4, olc::WHITE, HudText::Label{ "Screen position: " }, m_screenPosition.x, ", ", m_screenPosition.y);
+    t_hud.Draw(target, 500, 14, olc::WHITE, HudText::Label{ "Map position: " }, m_mapPosition.x, ", ", m_mapPosition.y);
+    t_hud.Draw(target, 500, 24, olc::WHITE, HudText::Label{ "Angle in rad: " }, radians);
+    t_hud.Draw(target, 500, 34, olc::WHITE, HudText::Label{ "Angle in deg: " }, radians * (180.0f / M_PI));
+
+#ifdef FPS_DEBUG_BUILD
+    // stage table
+    t_hud.Draw(target, 500, 58, olc::YELLOW, HudText::Label{ "Stage             avg ms  p99 ms" });
+    for (auto stage{ 0 }; stage < Profiler::STAGE_COUNT; ++stage)
+    {
+        const auto stats{ t_profiler.GetStats(static_cast<Profiler::Stage>(stage)) };
+        t_hud.Draw(target, 500, 68 + stage * 10, olc::WHITE, Profiler::STAGE_NAMES[stage]);
+        t_hud.Draw(target, 644, 68 + stage * 10, olc::WHITE, HudText::Fixed{ stats.avgMs, 3 });
+        t_hud.Draw(target, 708, 68 + stage * 10, olc::WHITE, HudText::Fixed{ stats.p99Ms, 3 });
+    }
+
+    // frame-time graph, newest frame on the right; the line marks 60 fps
+    constexpr auto graphX{ 500 };
+    constexpr auto graphY{ 142 };
+    constexpr auto graphHeight{ 50 };
+    constexpr auto graphMaxMs{ 33.3f };
+    constexpr auto targetMs{ 1000.0f / 60.0f };
+
+    t_pge->FillRect(graphX, graphY, Profiler::HISTORY_SIZE * 2, graphHeight, olc::VERY_DARK_GREY);
+
+    const auto frameCount{ t_profiler.GetFrameCount() };
+    for (auto age{ 0 }; age < frameCount; ++age)
     {
-        ray.Render(t_pge, t_xOffset, t_yOffset, t_scale);
+        const auto ms{ t_profiler.GetMilliseconds(Profiler::FRAME, age) };
+        const auto barHeight{ static_cast<int>(std::min(ms / graphMaxMs, 1.0f) * graphHeight) };
+        const auto x{ graphX + (Profiler::HISTORY_SIZE - 1 - age) * 2 };
+        t_pge->FillRect(x, graphY + graphHeight - barHeight, 2, barHeight, ms > targetMs ? olc::RED : olc::GREEN);
     }
+
+    const auto targetY{ graphY + graphHeight - static_cast<int>(targetMs / graphMaxMs * graphHeight) };
+    t_pge->DrawLine(graphX, targetY, graphX + Profiler::HISTORY_SIZE * 2 - 1, targetY, olc::WHITE);
+#endif
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+const CameraTable& Player::GetCameraTable() const
+{
+    return m_cameraTable;
+}
+
+const olc::vf2d& Player::GetScreenPosition() const
+{
+    return m_screenPosition;
 }
 
-void Player::RenderDebugInfo(olc::PixelGameEngine* t_pge) const
+const olc::vi2d& Player::GetMapPosition() const
 {
-    t_pge->DrawString(500, 4, "Screen position: " + to_string_with_precision(m_screenPosition.x) + ", " + to_string_with_precision(m_screenPosition.y), olc::WHITE);
-    t_pge->DrawString(500, 14, "Map position: " + std::to_string(m_mapPosition.x) + ", " + std::to_string(m_mapPosition.y), olc::WHITE);
-    t_pge->DrawString(500, 24, "Angle in rad: " + to_string_with_precision(radians), olc::WHITE);
-    t_pge->DrawString(500, 34, "Angle in deg: " + to_string_with_precision(radians * (180.0f / M_PI)), olc::WHITE);
+    return m_mapPosition;
 }
 
 //-------------------------------------------------
@@ -113,7 +299,7 @@ void Player::RenderDebugInfo(olc::PixelGameEngine* t_pge) const
 
 void Player::SetPositionsByMapXY(const int t_mapX, const int t_mapY)
 {
-    const auto tileSize{ Game::INI.Get<float>("map", "tile_size") };
+    const auto tileSize{ m_config.render.tileSize };
 
     m_screenPosition = map_to_screen(t_mapX, t_mapY, tileSize);
     m_mapPosition.x = t_mapX;
@@ -122,7 +308,7 @@ void Player::SetPositionsByMapXY(const int t_mapX, const int t_mapY)
 
 void Player::SetPositionsByScreenXY(const float t_screenX, const float t_screenY)
 {
-    const auto tileSize{ Game::INI.Get<float>("map", "tile_size") };
+    const auto tileSize{ m_config.render.tileSize };
 
     m_mapPosition = screen_to_map(t_screenX, t_screenY, tileSize);
     m_screenPosition.x = t_screenX;
@@ -135,7 +321,7 @@ void Player::SetPositionsByScreenXY(const float t_screenX, const float t_screenY
 
 void Player::GetVerticalIntersection(Ray& t_ray) const
 {
-    const auto tileSize{ Game::INI.Get<float>("map", "tile_size") };
+    const auto tileSize{ m_config.render.tileSize };
 
     const auto tanRayAngle{ tanf(t_ray.radians) };
     const auto facingRight{ is_facing_right(t_ray.radians) };
@@ -184,12 +370,12 @@ void Player::GetVerticalIntersection(Ray& t_ray) const
         const auto currentMapX{ currentMapPosition.x - (facingRight ? 0 : 1) };
         const auto currentMapY{ currentMapPosition.y };
 
-        if (is_position_not_on_map(currentMapX, currentMapY, Map::MAP_WIDTH, Map::MAP_HEIGHT))
+        if (is_position_not_on_map(currentMapX, currentMapY, m_map.GetWidth(), m_map.GetHeight()))
         {
             break;
         }
 
-        hitWall = Map::IsWallTypeAtMapPosition(currentMapX, currentMapY);
+        hitWall = m_map.IsWallTypeAtMapPosition(currentMapX, currentMapY);
         if (!hitWall)
         {
             currentScreenX += deltaXPerTile;
@@ -208,7 +394,7 @@ void Player::GetVerticalIntersection(Ray& t_ray) const
 
 void Player::GetHorizontalIntersection(Ray& t_ray) const
 {
-    const auto tileSize{ Game::INI.Get<float>("map", "tile_size") };
+    const auto tileSize{ m_config.render.tileSize };
 
     const auto tanRayAngle{ tanf(t_ray.radians) };
     const auto facingUp{ is_facing_up(t_ray.radians) };
@@ -229,12 +415,12 @@ void Player::GetHorizontalIntersection(Ray& t_ray) const
         const auto currentMapX{ currentMapPosition.x };
         const auto currentMapY{ currentMapPosition.y - (facingUp ? 1 : 0) };
 
-        if (is_position_not_on_map(currentMapX, currentMapY, Map::MAP_WIDTH, Map::MAP_HEIGHT))
+        if (is_position_not_on_map(currentMapX, currentMapY, m_map.GetWidth(), m_map.GetHeight()))
         {
             break;
         }
 
-        hitWall = Map::IsWallTypeAtMapPosition(currentMapX, currentMapY);
+        hitWall = m_map.IsWallTypeAtMapPosition(currentMapX, currentMapY);
         if (!hitWall)
         {
             currentScreenX += deltaXPerTile;
@@ -250,3 +436,9 @@ void Player::GetHorizontalIntersection(Ray& t_ray) const
         t_ray.length = sqrtf(dx * dx + dy * dy);
     }
 }
+
+void Player::TraceRay(Ray& t_ray) const
+{
+    const auto grid{ m_map.GetTraceGrid() };
+    trace_ray(grid, m_screenPosition.x, m_screenPosition.y, cosf(t_ray.radians), sinf(t_ray.radians), t_ray);
+}
@@ -1,6 +1,18 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include "Ray.h"
+#include "RayBuffer.h"
+#include "CameraTable.h"
+#include "Config.h"
+#include "Input.h"
+#include "Map.h"
+
+class JobSystem;
+class FrameArena;
+class HudText;
+class Profiler;
 
 //-------------------------------------------------
 // Player
@@ -22,15 +34,22 @@ public:
     float radians{ 0.0f };
 
     /**
-     * @brief A collection of rays representing the player's field of view.
+     * @brief The rays representing the player's field of view, sized once from the config.
      */
-    std::vector<Ray> rays;
+    RayBuffer rays;
 
     //-------------------------------------------------
     // Ctors. / Dtor.
     //-------------------------------------------------
 
-    Player();
+    /**
+     * @brief Constructs a new Player object at the configured start tile.
+     *
+     * @param t_config The config snapshot, which must outlive the player.
+     * @param t_map The map to move on and cast rays into, which must outlive the player.
+     * @param t_castsRays False for a player that only moves; it gets no ray buffer and must not cast.
+     */
+    Player(const Config& t_config, const Map& t_map, bool t_castsRays = true);
 
     Player(const Player& t_other) = delete;
     Player(Player&& t_other) noexcept = delete;
@@ -47,14 +66,31 @@ public:
      * @brief Handles player input for movement and rotation.
      *
      * @param t_dt The delta time since the last frame, used to adjust movement speed.
-     * @param t_pge Pointer to the PixelGameEngine object.
+     * @param t_input The held controls of the current frame.
      */
-    void HandleInput(float t_dt, const olc::PixelGameEngine* t_pge);
+    void HandleInput(float t_dt, const InputState& t_input);
 
     /**
      * @brief Casts rays to detect walls and other objects in the player's field of view.
+     *
+     * The screen columns are split into chunks and traced as jobs. The results are
+     * written into the persistent ray buffer.
+     *
+     * The view turns in whole columns: the rays are cast at the angle rounded to a multiple of
+     * FOV / rays. The results are kept while the position, that column, the FOV and the map
+     * version stay the same. A turn moves the kept results sideways and only casts the newly
+     * exposed columns; a turn across 0 recasts all of them.
+     *
+     * @param t_jobs The job system to run the chunks on.
+     *
+     * @return True if any ray was cast, false if the ray buffer is unchanged.
+     */
+    bool CastRays(JobSystem& t_jobs);
+
+    /**
+     * @brief Drops the kept results, so the next CastRays() casts every column.
      */
-    void CastRays();
+    void InvalidateRays();
 
     /**
      * @brief Renders the player.
@@ -63,32 +99,52 @@ public:
      * offset, and scale. It visually represents the player in the game world.
      *
      * @param t_pge Pointer to the PixelGameEngine object.
-     * @param t_xOffset The x-offset to apply to the player's position.
-     * @param t_yOffset The y-offset to apply to the player's position.
-     * @param t_scale The scale factor for rendering the player.
+     * @param t_view The mini-map view to draw into.
      */
-    void RenderPlayer(olc::PixelGameEngine* t_pge, float t_xOffset, float t_yOffset, float t_scale) const;
+    void RenderPlayer(olc::PixelGameEngine* t_pge, const Map::MiniMapView& t_view) const;
 
     /**
      * @brief Renders the rays cast from the player's position.
      *
      * This method visually represents the rays in the game world, allowing the
      * player to see the direction and length of each ray as they detect walls
-     * and objects.
+     * and objects. The rays are cut off at the border of the mini-map window.
      *
      * @param t_pge Pointer to the PixelGameEngine object.
-     * @param t_xOffset The x-offset.
-     * @param t_yOffset The y-offset.
-     * @param t_scale The scale factor.
+     * @param t_view The mini-map view to draw into.
+     * @param t_arena The arena of the current frame, which holds the hit markers until they are drawn.
      */
-    void RenderRays(olc::PixelGameEngine* t_pge, float t_xOffset, float t_yOffset, float t_scale) const;
+    void RenderRays(olc::PixelGameEngine* t_pge, const Map::MiniMapView& t_view, FrameArena& t_arena) const;
 
     /**
      * @brief Renders debug information.
      *
+     * Debug builds also show the per-stage timings and a frame-time graph of the profiler.
+     *
      * @param t_pge Pointer to the PixelGameEngine object.
+     * @param t_hud Draws the text into the current draw target.
+     * @param t_profiler The stage timings of the last frames.
+     */
+    void RenderDebugInfo(olc::PixelGameEngine* t_pge, HudText& t_hud, const Profiler& t_profiler) const;
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    /**
+     * @brief The per-column angles of the last cast.
+     */
+    [[nodiscard]] const CameraTable& GetCameraTable() const;
+
+    /**
+     * @brief The screen position of the player.
+     */
+    [[nodiscard]] const olc::vf2d& GetScreenPosition() const;
+
+    /**
+     * @brief The map position of the player.
      */
-    void RenderDebugInfo(olc::PixelGameEngine* t_pge) const;
+    [[nodiscard]] const olc::vi2d& GetMapPosition() const;
 
     //-------------------------------------------------
     // Setter
@@ -128,13 +184,53 @@ public:
      */
     void GetHorizontalIntersection(Ray& t_ray) const;
 
+    /**
+     * @brief Traces a ray through the map grid in a single pass (Amanatides-Woo DDA, see trace_ray()).
+     *
+     * Steps from tile boundary to tile boundary and stops at the first wall. The hit position,
+     * the type (VERTICAL for a wall hit on an x-boundary, HORIZONTAL on a y-boundary) and the
+     * length match the shorter result of GetVerticalIntersection() and GetHorizontalIntersection().
+     *
+     * @param t_ray Reference to the ray to trace.
+     */
+    void TraceRay(Ray& t_ray) const;
+
 protected:
 
 private:
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    /**
+     * @brief The inputs of the last cast besides the camera table.
+     */
+    struct CastKey
+    {
+        olc::vf2d screenPosition;
+
+        /**
+         * @brief The view angle in whole columns.
+         */
+        int column;
+
+        std::uint64_t mapVersion;
+    };
+
     //-------------------------------------------------
     // Member
     //-------------------------------------------------
 
+    /**
+     * @brief The config snapshot.
+     */
+    const Config& m_config;
+
+    /**
+     * @brief The map the player moves on.
+     */
+    const Map& m_map;
+
     /**
      * @brief The screen position of the player.
      */
@@ -144,4 +240,14 @@ private:
      * @brief The map position of the player.
      */
     olc::vi2d m_mapPosition{ 0, 0 };
+
+    /**
+     * @brief The cached per-column angles and directions.
+     */
+    CameraTable m_cameraTable;
+
+    /**
+     * @brief The inputs the ray buffer was cast with; empty before the first cast.
+     */
+    std::optional<CastKey> m_castKey;
 };
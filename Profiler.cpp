@@ -0,0 +1,70 @@
+#include <algorithm>
+#include "Profiler.h"
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void Profiler::Record(const Stage t_stage, const std::int64_t t_nanoseconds)
+{
+    const auto slot{ m_frame.load(std::memory_order_acquire) % HISTORY_SIZE };
+    m_samples[slot][t_stage].fetch_add(t_nanoseconds, std::memory_order_relaxed);
+}
+
+void Profiler::EndFrame()
+{
+    const auto now{ std::chrono::steady_clock::now() };
+    if (m_lastFrameEnd != std::chrono::steady_clock::time_point{})
+    {
+        Record(FRAME, std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_lastFrameEnd).count());
+    }
+    m_lastFrameEnd = now;
+
+    // clear the oldest slot before it becomes the current frame
+    const auto next{ m_frame.load(std::memory_order_relaxed) + 1 };
+    for (auto& sample : m_samples[next % HISTORY_SIZE])
+    {
+        sample.store(0, std::memory_order_relaxed);
+    }
+
+    m_frame.store(next, std::memory_order_release);
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+int Profiler::GetFrameCount() const
+{
+    // the slot of the current frame is still being written
+    return static_cast<int>(std::min<std::uint64_t>(m_frame.load(std::memory_order_acquire), HISTORY_SIZE - 1));
+}
+
+float Profiler::GetMilliseconds(const Stage t_stage, const int t_age) const
+{
+    const auto slot{ (m_frame.load(std::memory_order_acquire) - 1 - t_age) % HISTORY_SIZE };
+
+    return static_cast<float>(m_samples[slot][t_stage].load(std::memory_order_relaxed)) / 1'000'000.0f;
+}
+
+Profiler::StageStats Profiler::GetStats(const Stage t_stage) const
+{
+    const auto frameCount{ GetFrameCount() };
+    if (frameCount == 0)
+    {
+        return {};
+    }
+
+    std::array<float, HISTORY_SIZE> times;
+    auto sum{ 0.0f };
+    for (auto age{ 0 }; age < frameCount; ++age)
+    {
+        times[age] = GetMilliseconds(t_stage, age);
+        sum += times[age];
+    }
+
+    const auto p99Index{ (frameCount * 99) / 100 };
+    std::nth_element(times.begin(), times.begin() + p99Index, times.begin() + frameCount);
+
+    return { sum / static_cast<float>(frameCount), times[p99Index] };
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+//-------------------------------------------------
+// Profiler
+//-------------------------------------------------
+
+/**
+ * @brief Collects the time spent in each named stage of the last frames.
+ *
+ * The samples live in a fixed ring buffer of HISTORY_SIZE frames. Recording is
+ * lock-free and may happen from any thread; only EndFrame() must be called from
+ * the game thread.
+ */
+class Profiler
+{
+public:
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    enum Stage
+    {
+        FRAME,
+        UPDATE_POSE,
+        CAST_RAYS,
+        RENDER_MAP,
+        RENDER_MINI_MAP,
+        RENDER_RAYS,
+        RENDER_DEBUG_INFO,
+        STAGE_COUNT
+    };
+
+    struct StageStats
+    {
+        float avgMs{ 0.0f };
+        float p99Ms{ 0.0f };
+    };
+
+    //-------------------------------------------------
+    // Constants
+    //-------------------------------------------------
+
+    /**
+     * @brief The number of frames kept in the ring buffer.
+     */
+    static constexpr auto HISTORY_SIZE{ 128 };
+
+    static constexpr std::array<const char*, STAGE_COUNT> STAGE_NAMES{
+        "Frame", "UpdatePose", "CastRays", "Render", "RenderMiniMap", "RenderRays", "RenderDebugInfo"
+    };
+
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    Profiler() = default;
+
+    Profiler(const Profiler& t_other) = delete;
+    Profiler(Profiler&& t_other) noexcept = delete;
+    Profiler& operator=(const Profiler& t_other) = delete;
+    Profiler& operator=(Profiler&& t_other) noexcept = delete;
+
+    ~Profiler() noexcept = default;
+
+    //-------------------------------------------------
+    // Logic
+    //-------------------------------------------------
+
+    /**
+     * @brief Adds a duration to a stage of the current frame.
+     *
+     * @param t_stage The stage.
+     * @param t_nanoseconds The duration in nanoseconds.
+     */
+    void Record(Stage t_stage, std::int64_t t_nanoseconds);
+
+    /**
+     * @brief Completes the current frame and records the time since the previous call as FRAME.
+     */
+    void EndFrame();
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    /**
+     * @brief The number of completed frames in the ring buffer.
+     */
+    [[nodiscard]] int GetFrameCount() const;
+
+    /**
+     * @brief The duration of a stage in a completed frame.
+     *
+     * @param t_stage The stage.
+     * @param t_age 0 for the last completed frame, up to GetFrameCount() - 1.
+     *
+     * @return The duration in milliseconds.
+     */
+    [[nodiscard]] float GetMilliseconds(Stage t_stage, int t_age) const;
+
+    /**
+     * @brief The average and 99th percentile of a stage over the completed frames.
+     */
+    [[nodiscard]] StageStats GetStats(Stage t_stage) const;
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    std::array<std::array<std::atomic<std::int64_t>, STAGE_COUNT>, HISTORY_SIZE> m_samples{};
+
+    /**
+     * @brief The number of the frame being recorded; its slot is m_frame % HISTORY_SIZE.
+     */
+    std::atomic<std::uint64_t> m_frame{ 0 };
+
+    std::chrono::steady_clock::time_point m_lastFrameEnd{};
+};
+
+//-------------------------------------------------
+// ScopedTimer
+//-------------------------------------------------
+
+/**
+ * @brief Records the lifetime of the object as a stage of the current frame.
+ */
+class ScopedTimer
+{
+public:
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    ScopedTimer(Profiler& t_profiler, const Profiler::Stage t_stage)
+        : m_profiler{ t_profiler }
+        , m_stage{ t_stage }
+        , m_start{ std::chrono::steady_clock::now() }
+    {}
+
+    ScopedTimer(const ScopedTimer& t_other) = delete;
+    ScopedTimer(ScopedTimer&& t_other) noexcept = delete;
+    ScopedTimer& operator=(const ScopedTimer& t_other) = delete;
+    ScopedTimer& operator=(ScopedTimer&& t_other) noexcept = delete;
+
+    ~ScopedTimer() noexcept
+    {
+        const auto elapsed{ std::chrono::steady_clock::now() - m_start };
+        m_profiler.Record(m_stage, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    Profiler& m_profiler;
+    Profiler::Stage m_stage;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+//-------------------------------------------------
+// Macros
+//-------------------------------------------------
+
+#define FPS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define FPS_PROFILE_CONCAT(a, b)      FPS_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef FPS_DEBUG_BUILD
+    #define FPS_PROFILE_SCOPE(profiler, stage) ScopedTimer FPS_PROFILE_CONCAT(scopedTimer, __LINE__){ profiler, stage }
+    #define FPS_PROFILE_END_FRAME(profiler)    (profiler).EndFrame()
+#else
+    #define FPS_PROFILE_SCOPE(profiler, stage)
+    #define FPS_PROFILE_END_FRAME(profiler)
+#endif
@@ -2,6 +2,9 @@
 
 #include "olcPixelGameEngine.h"
 
+/**
+ * @brief A single ray and its hit, as produced by the traversal functions.
+ */
 class Ray
 {
 public:
@@ -21,11 +24,6 @@ public:
     // Member
     //-------------------------------------------------
 
-    /**
-     * @brief The screen position where the ray is cast from.
-     */
-    olc::vf2d screenPosition{ 0.0f, 0.0f };
-
     /**
      * @brief The length of the ray, initialized to the maximum float value.
      */
@@ -55,25 +53,10 @@ public:
     /**
      * @brief Constructs a new Ray object.
      *
-     * @param t_screenPosition The starting position of the ray on the screen.
      * @param t_radians The angle of the ray in radians.
      * @param t_type The type of the ray (vertical or horizontal).
      */
-    Ray(const olc::vf2d& t_screenPosition, float t_radians, RayType t_type);
-
-    //-------------------------------------------------
-    // Logic
-    //-------------------------------------------------
-
-    /**
-     * @brief Renders the ray on the screen.
-     *
-     * @param t_pge Pointer to the PixelGameEngine object.
-     * @param t_xOffset The x-offset.
-     * @param t_yOffset The y-offset.
-     * @param t_scale The scale factor.
-     */
-    void Render(olc::PixelGameEngine* t_pge, float t_xOffset, float t_yOffset, float t_scale) const;
+    Ray(float t_radians, RayType t_type);
 
 protected:
 
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include "RayBuffer.h"
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void RayBuffer::Resize(const int t_size)
+{
+    if (t_size == Size())
+    {
+        return;
+    }
+
+    m_lengths.assign(t_size, 0.0f);
+    m_radians.assign(t_size, 0.0f);
+    m_hitX.assign(t_size, 0.0f);
+    m_hitY.assign(t_size, 0.0f);
+    m_types.assign(t_size, Ray::VERTICAL);
+}
+
+void RayBuffer::Shift(const int t_columns)
+{
+    const auto shift{ [t_columns](auto& t_values) {
+        if (t_columns > 0)
+        {
+            std::copy(t_values.begin() + t_columns, t_values.end(), t_values.begin());
+        }
+        else if (t_columns < 0)
+        {
+            std::copy_backward(t_values.begin(), t_values.end() + t_columns, t_values.end());
+        }
+    } };
+
+    shift(m_lengths);
+    shift(m_hitX);
+    shift(m_hitY);
+    shift(m_types);
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+int RayBuffer::Size() const
+{
+    return static_cast<int>(m_lengths.size());
+}
+
+std::span<float> RayBuffer::GetLengths()
+{
+    return m_lengths;
+}
+
+std::span<const float> RayBuffer::GetLengths() const
+{
+    return m_lengths;
+}
+
+std::span<float> RayBuffer::GetRadians()
+{
+    return m_radians;
+}
+
+std::span<const float> RayBuffer::GetRadians() const
+{
+    return m_radians;
+}
+
+std::span<float> RayBuffer::GetHitX()
+{
+    return m_hitX;
+}
+
+std::span<const float> RayBuffer::GetHitX() const
+{
+    return m_hitX;
+}
+
+std::span<float> RayBuffer::GetHitY()
+{
+    return m_hitY;
+}
+
+std::span<const float> RayBuffer::GetHitY() const
+{
+    return m_hitY;
+}
+
+std::span<Ray::RayType> RayBuffer::GetTypes()
+{
+    return m_types;
+}
+
+std::span<const Ray::RayType> RayBuffer::GetTypes() const
+{
+    return m_types;
+}
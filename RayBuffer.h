@@ -0,0 +1,103 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include "Ray.h"
+
+//-------------------------------------------------
+// RayBuffer
+//-------------------------------------------------
+
+/**
+ * @brief Persistent structure-of-arrays storage for the rays of a frame.
+ *
+ * Each ray attribute lives in its own contiguous array. The arrays are only
+ * reallocated when the number of rays changes, so casting a frame does not
+ * touch the heap.
+ */
+class RayBuffer
+{
+public:
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    RayBuffer() = default;
+
+    RayBuffer(const RayBuffer& t_other) = delete;
+    RayBuffer(RayBuffer&& t_other) noexcept = delete;
+    RayBuffer& operator=(const RayBuffer& t_other) = delete;
+    RayBuffer& operator=(RayBuffer&& t_other) noexcept = delete;
+
+    ~RayBuffer() noexcept = default;
+
+    //-------------------------------------------------
+    // Logic
+    //-------------------------------------------------
+
+    /**
+     * @brief Sets the number of rays; only allocates if the size changes.
+     *
+     * @param t_size The number of rays.
+     */
+    void Resize(int t_size);
+
+    /**
+     * @brief Moves the results of the rays sideways, e.g. after the view turned by whole columns.
+     *
+     * Ray i takes the results of ray i + t_columns. The rays whose source is outside the
+     * buffer keep stale results and must be cast again. The angles aren't moved.
+     *
+     * @param t_columns The number of columns to move by, less than Size() in magnitude.
+     */
+    void Shift(int t_columns);
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    [[nodiscard]] int Size() const;
+
+    /**
+     * @brief The length of each ray from the origin to the hit position.
+     */
+    [[nodiscard]] std::span<float> GetLengths();
+    [[nodiscard]] std::span<const float> GetLengths() const;
+
+    /**
+     * @brief The angle of each ray in radians.
+     */
+    [[nodiscard]] std::span<float> GetRadians();
+    [[nodiscard]] std::span<const float> GetRadians() const;
+
+    /**
+     * @brief The x-coordinate on the screen where each ray hits a wall.
+     */
+    [[nodiscard]] std::span<float> GetHitX();
+    [[nodiscard]] std::span<const float> GetHitX() const;
+
+    /**
+     * @brief The y-coordinate on the screen where each ray hits a wall.
+     */
+    [[nodiscard]] std::span<float> GetHitY();
+    [[nodiscard]] std::span<const float> GetHitY() const;
+
+    /**
+     * @brief The side of the wall each ray hits.
+     */
+    [[nodiscard]] std::span<Ray::RayType> GetTypes();
+    [[nodiscard]] std::span<const Ray::RayType> GetTypes() const;
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    std::vector<float> m_lengths;
+    std::vector<float> m_radians;
+    std::vector<float> m_hitX;
+    std::vector<float> m_hitY;
+    std::vector<Ray::RayType> m_types;
+};
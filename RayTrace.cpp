@@ -0,0 +1,561 @@
+#include "RayTrace.h"
+#include "Utils.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+    #include <immintrin.h>
+    #define FPS_RAY_PACKET_AVX2
+#endif
+
+//-------------------------------------------------
+// Scalar
+//-------------------------------------------------
+
+/**
+ * @brief The distance along the ray to its t_count-th crossing of a tile boundary in x or y.
+ *
+ * Computed from the count rather than by summing, so any crossing can be reached directly
+ * and both the jumps over empty squares and the AVX2 kernel arrive at the same value.
+ */
+static float crossing_distance(const float t_first, const float t_delta, const int t_count)
+{
+    return t_first + static_cast<float>(t_count) * t_delta;
+}
+
+/**
+ * @brief The first crossing at or after t_count whose distance passes t_distance.
+ *
+ * @param t_inclusive True finds the first distance >= t_distance, false the first > t_distance.
+ */
+static int first_crossing_after(
+    const float t_first, const float t_delta,
+    const int t_count, const int t_maxCount,
+    const float t_distance, const bool t_inclusive
+)
+{
+    const auto passes{ [&](const int t_i) {
+        const auto d{ crossing_distance(t_first, t_delta, t_i) };
+        return t_inclusive ? d >= t_distance : d > t_distance;
+    } };
+
+    // the ray never crosses this axis
+    if (std::isinf(t_first))
+    {
+        return t_count;
+    }
+
+    // estimate, then settle on the exact crossing
+    auto i{ std::clamp(static_cast<int>((t_distance - t_first) / t_delta), t_count, t_maxCount) };
+    while (i > t_count && passes(i - 1))
+    {
+        --i;
+    }
+    while (!passes(i))
+    {
+        ++i;
+    }
+
+    return i;
+}
+
+/**
+ * @brief Where a ray stands after a jump over an empty square: its tile, the crossings per
+ *        axis and the distance and side of the last crossing.
+ */
+struct SquareExit
+{
+    int countX;
+    int countY;
+    float distance;
+    Ray::RayType type;
+};
+
+/**
+ * @brief Crosses an empty square around the ray's tile in one jump.
+ *
+ * Kept out of line so the per-tile step in trace_ray() stays in registers.
+ *
+ * @param t_squareX The first tile column of the square.
+ * @param t_squareY The first tile row of the square.
+ * @param t_size The number of tiles per side of the square.
+ */
+__attribute__((noinline))
+static SquareExit cross_empty_square(
+    const int t_squareX, const int t_squareY, const int t_size,
+    const int t_mapX, const int t_mapY,
+    const int t_stepX, const int t_stepY,
+    const int t_countX, const int t_countY,
+    const float t_firstDistX, const float t_firstDistY,
+    const float t_deltaDistX, const float t_deltaDistY
+)
+{
+    // The ray leaves the square at its exitX-th x or exitY-th y crossing, whichever is nearer;
+    // every crossing of the other axis before that stays inside the square.
+    const auto exitX{ t_countX + (t_stepX > 0 ? t_squareX + t_size - t_mapX : t_mapX - t_squareX + 1) - 1 };
+    const auto exitY{ t_countY + (t_stepY > 0 ? t_squareY + t_size - t_mapY : t_mapY - t_squareY + 1) - 1 };
+    const auto exitDistX{ crossing_distance(t_firstDistX, t_deltaDistX, exitX) };
+    const auto exitDistY{ crossing_distance(t_firstDistY, t_deltaDistY, exitY) };
+
+    // the same tie-break as a single step: x only if strictly nearer
+    if (exitDistX < exitDistY)
+    {
+        return {
+            exitX + 1,
+            first_crossing_after(t_firstDistY, t_deltaDistY, t_countY, exitY, exitDistX, false),
+            exitDistX,
+            Ray::VERTICAL
+        };
+    }
+
+    return {
+        first_crossing_after(t_firstDistX, t_deltaDistX, t_countX, exitX, exitDistY, true),
+        exitY + 1,
+        exitDistY,
+        Ray::HORIZONTAL
+    };
+}
+
+/**
+ * @brief An empty square around a free tile, crossed in one jump.
+ */
+struct EmptySquare
+{
+    int x;
+    int y;
+    int size;
+};
+
+/**
+ * @brief The empty square around a free tile: with a distance field the square centered on it,
+ *        with a pyramid the largest empty square of its level if the tile's block is empty.
+ *
+ * @param t_block The block that holds the tile.
+ * @return The square, a size of 1 or less if the ray has to step to the next tile.
+ */
+static EmptySquare find_empty_square(const TraceGrid& t_grid, const int t_mapX, const int t_mapY, const std::uint64_t t_block)
+{
+    if (t_grid.distances)
+    {
+        const auto radius{ t_grid.distances[t_mapY * t_grid.width + t_mapX] - 1 };
+        return { t_mapX - radius, t_mapY - radius, 2 * radius + 1 };
+    }
+
+    if (t_block == 0 && t_grid.pyramid)
+    {
+        const auto size{ OccupancyGrid::BLOCK_SIZE << t_grid.pyramid->GetEmptyLevel(t_mapX, t_mapY) };
+        return { t_mapX & ~(size - 1), t_mapY & ~(size - 1), size };
+    }
+
+    return { 0, 0, 0 };
+}
+
+int trace_ray(
+    const TraceGrid& t_grid,
+    const float t_originX, const float t_originY,
+    const float t_dirX, const float t_dirY,
+    Ray& t_ray
+)
+{
+    const auto tileSize{ t_grid.tileSize };
+    constexpr auto infinity{ std::numeric_limits<float>::infinity() };
+
+    const auto width{ t_grid.width };
+    const auto height{ t_grid.height };
+
+    const auto startMapPosition{ screen_to_map(t_originX, t_originY, tileSize) };
+    auto mapX{ startMapPosition.x };
+    auto mapY{ startMapPosition.y };
+
+    const auto stepX{ t_dirX > 0.0f ? 1 : -1 };
+    const auto stepY{ t_dirY > 0.0f ? 1 : -1 };
+
+    // distance along the ray to cross one whole tile in x or y; 0 if the ray never crosses,
+    // so the crossing distances stay at the infinite first one
+    const auto deltaDistX{ t_dirX != 0.0f ? tileSize / fabsf(t_dirX) : 0.0f };
+    const auto deltaDistY{ t_dirY != 0.0f ? tileSize / fabsf(t_dirY) : 0.0f };
+
+    // distance along the ray to the first x and y tile boundary
+    const auto tileLeft{ static_cast<float>(mapX) * tileSize };
+    const auto tileTop{ static_cast<float>(mapY) * tileSize };
+    const auto firstDistX{ t_dirX != 0.0f
+        ? (stepX > 0 ? tileLeft + tileSize - t_originX : t_originX - tileLeft) / fabsf(t_dirX)
+        : infinity
+    };
+    const auto firstDistY{ t_dirY != 0.0f
+        ? (stepY > 0 ? tileTop + tileSize - t_originY : t_originY - tileTop) / fabsf(t_dirY)
+        : infinity
+    };
+
+    // the number of x and y boundaries crossed so far (whole floats, as crossing_distance()
+    // would convert them) and the distance to the next one
+    auto crossingsX{ 0.0f };
+    auto crossingsY{ 0.0f };
+    auto sideDistX{ firstDistX };
+    auto sideDistY{ firstDistY };
+
+    // step to the nearest boundary until a wall is found or the ray leaves the map
+    auto distance{ 0.0f };
+    auto type{ Ray::VERTICAL };
+    auto jumps{ 0 };
+    while (true)
+    {
+        if (sideDistX < sideDistY)
+        {
+            distance = sideDistX;
+            crossingsX += 1.0f;
+            sideDistX = firstDistX + crossingsX * deltaDistX;
+            mapX += stepX;
+            type = Ray::VERTICAL;
+        }
+        else
+        {
+            distance = sideDistY;
+            crossingsY += 1.0f;
+            sideDistY = firstDistY + crossingsY * deltaDistY;
+            mapY += stepY;
+            type = Ray::HORIZONTAL;
+        }
+
+        if (is_position_not_on_map(mapX, mapY, width, height))
+        {
+            break;
+        }
+
+        const auto block{ t_grid.GetBlock(mapX, mapY) };
+        if ((block >> OccupancyGrid::BitIndex(mapX, mapY)) & 1)
+        {
+            break;
+        }
+
+        // From an empty block or a tile away from the walls, jump to the crossing that leaves
+        // the empty square around it and continue from the tile behind it, which may be a wall
+        // or off the map.
+        const auto square{ find_empty_square(t_grid, mapX, mapY, block) };
+        if (square.size > 1)
+        {
+            ++jumps;
+            const auto exit{ cross_empty_square(
+                square.x, square.y, square.size, mapX, mapY, stepX, stepY,
+                static_cast<int>(crossingsX), static_cast<int>(crossingsY),
+                firstDistX, firstDistY, deltaDistX, deltaDistY
+            ) };
+
+            mapX = startMapPosition.x + exit.countX * stepX;
+            mapY = startMapPosition.y + exit.countY * stepY;
+            crossingsX = static_cast<float>(exit.countX);
+            crossingsY = static_cast<float>(exit.countY);
+            sideDistX = crossing_distance(firstDistX, deltaDistX, exit.countX);
+            sideDistY = crossing_distance(firstDistY, deltaDistY, exit.countY);
+            distance = exit.distance;
+            type = exit.type;
+
+            if (is_position_not_on_map(mapX, mapY, width, height) || t_grid.IsWall(mapX, mapY))
+            {
+                break;
+            }
+        }
+    }
+
+    t_ray.type = type;
+    t_ray.length = distance;
+    t_ray.screenHitPosition.x = t_originX + t_dirX * distance;
+    t_ray.screenHitPosition.y = t_originY + t_dirY * distance;
+
+    return jumps;
+}
+
+//-------------------------------------------------
+// AVX2
+//-------------------------------------------------
+
+#ifdef FPS_RAY_PACKET_AVX2
+
+/*
+    Same arithmetic as trace_ray(), one ray per lane. The lanes step tile by tile together;
+    a lane that stands in an empty block leaves the vectors and crosses the empty square
+    around its tile with the scalar jump, which lands where the steps would. A lane stays
+    active until it hits a wall or leaves the map; finished lanes are masked out of every
+    update, so the results are bit-identical to the scalar path.
+*/
+__attribute__((target("avx2")))
+static int trace_ray_packet_avx2(
+    const TraceGrid& t_grid,
+    const float t_originX, const float t_originY,
+    RayPacket& t_packet,
+    const int t_count
+)
+{
+    const auto tileSize{ t_grid.tileSize };
+    const auto startMapPosition{ screen_to_map(t_originX, t_originY, tileSize) };
+    const auto tileLeft{ static_cast<float>(startMapPosition.x) * tileSize };
+    const auto tileTop{ static_cast<float>(startMapPosition.y) * tileSize };
+
+    const auto zero{ _mm256_setzero_ps() };
+    const auto infinity{ _mm256_set1_ps(std::numeric_limits<float>::infinity()) };
+    const auto tileSizeV{ _mm256_set1_ps(tileSize) };
+    const auto absMask{ _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)) };
+
+    const auto dirX{ _mm256_load_ps(t_packet.dirX) };
+    const auto dirY{ _mm256_load_ps(t_packet.dirY) };
+    const auto absDirX{ _mm256_and_ps(dirX, absMask) };
+    const auto absDirY{ _mm256_and_ps(dirY, absMask) };
+
+    const auto positiveX{ _mm256_cmp_ps(dirX, zero, _CMP_GT_OQ) };
+    const auto positiveY{ _mm256_cmp_ps(dirY, zero, _CMP_GT_OQ) };
+    const auto nonZeroX{ _mm256_cmp_ps(dirX, zero, _CMP_NEQ_OQ) };
+    const auto nonZeroY{ _mm256_cmp_ps(dirY, zero, _CMP_NEQ_OQ) };
+
+    const auto stepX{ _mm256_blendv_epi8(_mm256_set1_epi32(-1), _mm256_set1_epi32(1), _mm256_castps_si256(positiveX)) };
+    const auto stepY{ _mm256_blendv_epi8(_mm256_set1_epi32(-1), _mm256_set1_epi32(1), _mm256_castps_si256(positiveY)) };
+
+    const auto deltaDistX{ _mm256_and_ps(_mm256_div_ps(tileSizeV, absDirX), nonZeroX) };
+    const auto deltaDistY{ _mm256_and_ps(_mm256_div_ps(tileSizeV, absDirY), nonZeroY) };
+
+    const auto firstX{ _mm256_blendv_ps(
+        _mm256_set1_ps(t_originX - tileLeft), _mm256_set1_ps(tileLeft + tileSize - t_originX), positiveX
+    ) };
+    const auto firstY{ _mm256_blendv_ps(
+        _mm256_set1_ps(t_originY - tileTop), _mm256_set1_ps(tileTop + tileSize - t_originY), positiveY
+    ) };
+    const auto firstDistX{ _mm256_blendv_ps(infinity, _mm256_div_ps(firstX, absDirX), nonZeroX) };
+    const auto firstDistY{ _mm256_blendv_ps(infinity, _mm256_div_ps(firstY, absDirY), nonZeroY) };
+    auto sideDistX{ firstDistX };
+    auto sideDistY{ firstDistY };
+
+    // the crossings so far as floats; see crossing_distance()
+    auto crossingsX{ zero };
+    auto crossingsY{ zero };
+    const auto oneF{ _mm256_set1_ps(1.0f) };
+
+    auto mapX{ _mm256_set1_epi32(startMapPosition.x) };
+    auto mapY{ _mm256_set1_epi32(startMapPosition.y) };
+    const auto width{ _mm256_set1_epi32(t_grid.width) };
+    const auto height{ _mm256_set1_epi32(t_grid.height) };
+    const auto minusOne{ _mm256_set1_epi32(-1) };
+    const auto blocksPerRow{ _mm256_set1_epi32(t_grid.blocksPerRow) };
+    const auto blockMask{ _mm256_set1_epi32(OccupancyGrid::BLOCK_MASK) };
+
+    // a streamed grid finds the blocks through the chunk table
+    const auto* chunks{ reinterpret_cast<const int*>(t_grid.chunks) };
+    const auto chunkShift{ _mm_cvtsi32_si128(t_grid.chunkShift) };
+    const auto chunkMask{ _mm256_set1_epi32((1 << t_grid.chunkShift) - 1) };
+    const auto chunksPerRow{ _mm256_set1_epi32(t_grid.chunksPerRow) };
+    const auto one{ _mm256_set1_epi32(1) };
+
+    auto distance{ zero };
+    auto type{ _mm256_set1_epi32(Ray::VERTICAL) };
+    const auto vertical{ _mm256_set1_epi32(Ray::VERTICAL) };
+    const auto horizontal{ _mm256_set1_epi32(Ray::HORIZONTAL) };
+    auto active{ _mm256_cmpgt_epi32(_mm256_set1_epi32(t_count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)) };
+
+    // the per-lane constants of the scalar jumps
+    const auto canJump{ t_grid.pyramid != nullptr || t_grid.distances != nullptr };
+    alignas(32) int laneStepX[RayPacket::SIZE];
+    alignas(32) int laneStepY[RayPacket::SIZE];
+    alignas(32) float laneFirstDistX[RayPacket::SIZE];
+    alignas(32) float laneFirstDistY[RayPacket::SIZE];
+    alignas(32) float laneDeltaDistX[RayPacket::SIZE];
+    alignas(32) float laneDeltaDistY[RayPacket::SIZE];
+    if (canJump)
+    {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneStepX), stepX);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneStepY), stepY);
+        _mm256_store_ps(laneFirstDistX, firstDistX);
+        _mm256_store_ps(laneFirstDistY, firstDistY);
+        _mm256_store_ps(laneDeltaDistX, deltaDistX);
+        _mm256_store_ps(laneDeltaDistY, deltaDistY);
+    }
+    auto jumps{ 0 };
+
+    while (!_mm256_testz_si256(active, active))
+    {
+        // All lanes keep stepping, so the traversal itself never waits for the gather;
+        // a finished lane only stops updating its result.
+        const auto stepsX{ _mm256_cmp_ps(sideDistX, sideDistY, _CMP_LT_OQ) };
+        const auto stepsXi{ _mm256_castps_si256(stepsX) };
+
+        const auto nextDistance{ _mm256_blendv_ps(sideDistY, sideDistX, stepsX) };
+        const auto nextType{ _mm256_blendv_epi8(horizontal, vertical, stepsXi) };
+        crossingsX = _mm256_add_ps(crossingsX, _mm256_and_ps(oneF, stepsX));
+        crossingsY = _mm256_add_ps(crossingsY, _mm256_andnot_ps(stepsX, oneF));
+        sideDistX = _mm256_add_ps(firstDistX, _mm256_mul_ps(crossingsX, deltaDistX));
+        sideDistY = _mm256_add_ps(firstDistY, _mm256_mul_ps(crossingsY, deltaDistY));
+        mapX = _mm256_add_epi32(mapX, _mm256_and_si256(stepX, stepsXi));
+        mapY = _mm256_add_epi32(mapY, _mm256_andnot_si256(stepsXi, stepY));
+
+        distance = _mm256_blendv_ps(distance, nextDistance, _mm256_castsi256_ps(active));
+        type = _mm256_blendv_epi8(type, nextType, active);
+
+        // 0 <= mapX < width && 0 <= mapY < height
+        const auto onMap{ _mm256_and_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi32(mapX, minusOne), _mm256_cmpgt_epi32(width, mapX)),
+            _mm256_and_si256(_mm256_cmpgt_epi32(mapY, minusOne), _mm256_cmpgt_epi32(height, mapY))
+        ) };
+
+        // gather the wall bits of the lanes that are still on the map: the 32-bit half
+        // of the block word that holds the tile's row, then the tile's bit in it
+        const auto gatherMask{ _mm256_and_si256(active, onMap) };
+        auto blockX{ mapX };
+        auto blockY{ mapY };
+        auto chunkOffset{ _mm256_setzero_si256() };
+        if (chunks)
+        {
+            const auto chunk{ _mm256_add_epi32(
+                _mm256_mullo_epi32(_mm256_sra_epi32(mapY, chunkShift), chunksPerRow),
+                _mm256_sra_epi32(mapX, chunkShift)
+            ) };
+            chunkOffset = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), chunks, chunk, gatherMask, 4);
+            blockX = _mm256_and_si256(mapX, chunkMask);
+            blockY = _mm256_and_si256(mapY, chunkMask);
+        }
+        const auto blockIndex{ _mm256_add_epi32(chunkOffset, _mm256_add_epi32(
+            _mm256_mullo_epi32(_mm256_srai_epi32(blockY, OccupancyGrid::BLOCK_SHIFT), blocksPerRow),
+            _mm256_srai_epi32(blockX, OccupancyGrid::BLOCK_SHIFT)
+        )) };
+        const auto rowInBlock{ _mm256_and_si256(mapY, blockMask) };
+        const auto index{ _mm256_add_epi32(_mm256_slli_epi32(blockIndex, 1), _mm256_srli_epi32(rowInBlock, 2)) };
+        const auto bit{ _mm256_or_si256(
+            _mm256_slli_epi32(_mm256_and_si256(rowInBlock, _mm256_set1_epi32(3)), OccupancyGrid::BLOCK_SHIFT),
+            _mm256_and_si256(mapX, blockMask)
+        ) };
+        const auto words{ _mm256_mask_i32gather_epi32(
+            _mm256_setzero_si256(), reinterpret_cast<const int*>(t_grid.blocks), index, gatherMask, 4
+        ) };
+        const auto hitWall{ _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_srlv_epi32(words, bit), one), one) };
+
+        // a lane is done when it hits a wall or leaves the map
+        active = _mm256_andnot_si256(hitWall, gatherMask);
+
+        // A lane in an empty block leaves the vectors for a jump; the other half of the block
+        // is only gathered for the lanes whose half is empty. The distance field can also
+        // jump next to walls, but only its lanes in an empty block are taken out.
+        if (!canJump)
+        {
+            continue;
+        }
+        const auto emptyHalf{ _mm256_and_si256(active, _mm256_cmpeq_epi32(words, _mm256_setzero_si256())) };
+        if (_mm256_testz_si256(emptyHalf, emptyHalf))
+        {
+            continue;
+        }
+        const auto otherWords{ _mm256_mask_i32gather_epi32(
+            _mm256_setzero_si256(), reinterpret_cast<const int*>(t_grid.blocks),
+            _mm256_xor_si256(index, one), emptyHalf, 4
+        ) };
+        const auto emptyBlock{ _mm256_and_si256(emptyHalf, _mm256_cmpeq_epi32(otherWords, _mm256_setzero_si256())) };
+        auto jumpLanes{ _mm256_movemask_ps(_mm256_castsi256_ps(emptyBlock)) };
+        if (jumpLanes == 0)
+        {
+            continue;
+        }
+
+        alignas(32) int laneMapX[RayPacket::SIZE];
+        alignas(32) int laneMapY[RayPacket::SIZE];
+        alignas(32) float laneCrossingsX[RayPacket::SIZE];
+        alignas(32) float laneCrossingsY[RayPacket::SIZE];
+        alignas(32) float laneDistance[RayPacket::SIZE];
+        alignas(32) int laneType[RayPacket::SIZE];
+        alignas(32) int laneActive[RayPacket::SIZE];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneMapX), mapX);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneMapY), mapY);
+        _mm256_store_ps(laneCrossingsX, crossingsX);
+        _mm256_store_ps(laneCrossingsY, crossingsY);
+        _mm256_store_ps(laneDistance, distance);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneType), type);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneActive), active);
+
+        // the same jump as trace_ray(), including the check of the tile behind the square
+        while (jumpLanes != 0)
+        {
+            const auto lane{ __builtin_ctz(jumpLanes) };
+            jumpLanes &= jumpLanes - 1;
+
+            const auto square{ find_empty_square(t_grid, laneMapX[lane], laneMapY[lane], 0) };
+            if (square.size <= 1)
+            {
+                continue;
+            }
+
+            ++jumps;
+            const auto exit{ cross_empty_square(
+                square.x, square.y, square.size, laneMapX[lane], laneMapY[lane], laneStepX[lane], laneStepY[lane],
+                static_cast<int>(laneCrossingsX[lane]), static_cast<int>(laneCrossingsY[lane]),
+                laneFirstDistX[lane], laneFirstDistY[lane], laneDeltaDistX[lane], laneDeltaDistY[lane]
+            ) };
+
+            laneMapX[lane] = startMapPosition.x + exit.countX * laneStepX[lane];
+            laneMapY[lane] = startMapPosition.y + exit.countY * laneStepY[lane];
+            laneCrossingsX[lane] = static_cast<float>(exit.countX);
+            laneCrossingsY[lane] = static_cast<float>(exit.countY);
+            laneDistance[lane] = exit.distance;
+            laneType[lane] = exit.type;
+
+            if (is_position_not_on_map(laneMapX[lane], laneMapY[lane], t_grid.width, t_grid.height) ||
+                t_grid.IsWall(laneMapX[lane], laneMapY[lane]))
+            {
+                laneActive[lane] = 0;
+            }
+        }
+
+        mapX = _mm256_load_si256(reinterpret_cast<const __m256i*>(laneMapX));
+        mapY = _mm256_load_si256(reinterpret_cast<const __m256i*>(laneMapY));
+        crossingsX = _mm256_load_ps(laneCrossingsX);
+        crossingsY = _mm256_load_ps(laneCrossingsY);
+        distance = _mm256_load_ps(laneDistance);
+        type = _mm256_load_si256(reinterpret_cast<const __m256i*>(laneType));
+        active = _mm256_load_si256(reinterpret_cast<const __m256i*>(laneActive));
+        sideDistX = _mm256_add_ps(firstDistX, _mm256_mul_ps(crossingsX, deltaDistX));
+        sideDistY = _mm256_add_ps(firstDistY, _mm256_mul_ps(crossingsY, deltaDistY));
+    }
+
+    _mm256_store_ps(t_packet.length, distance);
+    _mm256_store_ps(t_packet.hitX, _mm256_add_ps(_mm256_set1_ps(t_originX), _mm256_mul_ps(dirX, distance)));
+    _mm256_store_ps(t_packet.hitY, _mm256_add_ps(_mm256_set1_ps(t_originY), _mm256_mul_ps(dirY, distance)));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(t_packet.type), type);
+
+    return jumps;
+}
+
+#endif
+
+//-------------------------------------------------
+// Dispatch
+//-------------------------------------------------
+
+bool is_simd_ray_packet_supported()
+{
+#ifdef FPS_RAY_PACKET_AVX2
+    static const auto supported{ __builtin_cpu_supports("avx2") != 0 };
+    return supported;
+#else
+    return false;
+#endif
+}
+
+int trace_ray_packet(
+    const TraceGrid& t_grid,
+    const float t_originX, const float t_originY,
+    RayPacket& t_packet,
+    const int t_count,
+    const bool t_simd
+)
+{
+#ifdef FPS_RAY_PACKET_AVX2
+    if (t_simd && is_simd_ray_packet_supported())
+    {
+        return trace_ray_packet_avx2(t_grid, t_originX, t_originY, t_packet, t_count);
+    }
+#endif
+
+    Ray ray{ 0.0f, Ray::VERTICAL };
+    auto jumps{ 0 };
+    for (auto i{ 0 }; i < t_count; ++i)
+    {
+        jumps += trace_ray(t_grid, t_originX, t_originY, t_packet.dirX[i], t_packet.dirY[i], ray);
+        t_packet.length[i] = ray.length;
+        t_packet.hitX[i] = ray.screenHitPosition.x;
+        t_packet.hitY[i] = ray.screenHitPosition.y;
+        t_packet.type[i] = ray.type;
+    }
+
+    return jumps;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstdint>
+#include "OccupancyGrid.h"
+#include "Ray.h"
+
+//-------------------------------------------------
+// TraceGrid
+//-------------------------------------------------
+
+/**
+ * @brief A read-only view of the wall bits used by the ray traversal, see OccupancyGrid.
+ */
+struct TraceGrid
+{
+    /**
+     * @brief The 8x8 tile blocks, one 64-bit word each; row-major over the whole map, or per chunk if chunks is set.
+     */
+    const std::uint64_t* blocks{ nullptr };
+
+    /**
+     * @brief The number of blocks in a row of the map, or of a chunk if chunks is set.
+     */
+    int blocksPerRow{ 0 };
+
+    int width{ 0 };
+    int height{ 0 };
+
+    /**
+     * @brief The size of a tile in screen units.
+     */
+    float tileSize{ 0.0f };
+
+    /**
+     * @brief The grid with the pyramid levels for crossing empty space; null steps tile by tile.
+     */
+    const OccupancyGrid* pyramid{ nullptr };
+
+    /**
+     * @brief The Chebyshev distance to the nearest wall of each tile, see DistanceField;
+     *        used instead of the pyramid if set.
+     */
+    const std::uint8_t* distances{ nullptr };
+
+    /**
+     * @brief The offset in blocks of each chunk's blocks, row-major by chunk, for a streamed grid; otherwise null.
+     */
+    const std::uint32_t* chunks{ nullptr };
+
+    /**
+     * @brief log2 of the number of tiles per chunk side.
+     */
+    int chunkShift{ 0 };
+
+    int chunksPerRow{ 0 };
+
+    /**
+     * @brief The block of a position that is on the map.
+     */
+    [[nodiscard]] std::uint64_t GetBlock(const int t_mapX, const int t_mapY) const
+    {
+        if (!chunks)
+        {
+            return blocks[OccupancyGrid::BlockIndex(t_mapX, t_mapY, blocksPerRow)];
+        }
+
+        const auto mask{ (1 << chunkShift) - 1 };
+        const auto chunk{ (t_mapY >> chunkShift) * chunksPerRow + (t_mapX >> chunkShift) };
+
+        return blocks[chunks[chunk] + OccupancyGrid::BlockIndex(t_mapX & mask, t_mapY & mask, blocksPerRow)];
+    }
+
+    /**
+     * @brief Checks the wall bit of a position that is on the map.
+     */
+    [[nodiscard]] bool IsWall(const int t_mapX, const int t_mapY) const
+    {
+        return (GetBlock(t_mapX, t_mapY) >> OccupancyGrid::BitIndex(t_mapX, t_mapY)) & 1;
+    }
+};
+
+//-------------------------------------------------
+// RayPacket
+//-------------------------------------------------
+
+/**
+ * @brief Input and output of up to SIZE neighbouring rays that share an origin.
+ */
+struct RayPacket
+{
+    static constexpr auto SIZE{ 8 };
+
+    // input
+    alignas(32) float dirX[SIZE];
+    alignas(32) float dirY[SIZE];
+
+    // output
+    alignas(32) float length[SIZE];
+    alignas(32) float hitX[SIZE];
+    alignas(32) float hitY[SIZE];
+    alignas(32) int type[SIZE];
+};
+
+//-------------------------------------------------
+// Traversal
+//-------------------------------------------------
+
+/**
+ * @brief Traces a single ray through the grid (Amanatides-Woo DDA) until the first wall.
+ *
+ * With a pyramid, the ray crosses the largest empty square around its tile in one jump;
+ * with a distance field, the empty square centered on its tile.
+ * The boundary distances are computed from the crossing counts, so a jump lands on exactly
+ * the tile, distance and side the tile-by-tile walk reaches.
+ *
+ * @param t_grid The map tiles.
+ * @param t_originX The x-coordinate of the ray origin on the screen.
+ * @param t_originY The y-coordinate of the ray origin on the screen.
+ * @param t_dirX The x-component of the normalized ray direction.
+ * @param t_dirY The y-component of the normalized ray direction.
+ * @param t_ray Receives the length, the hit position and the type of the hit.
+ * @return The number of jumps over empty squares.
+ */
+int trace_ray(
+    const TraceGrid& t_grid,
+    float t_originX, float t_originY,
+    float t_dirX, float t_dirY,
+    Ray& t_ray
+);
+
+/**
+ * @brief Traces the first t_count rays of a packet.
+ *
+ * Uses an 8-wide AVX2 kernel when the CPU supports it and falls back to trace_ray() otherwise.
+ * Both paths jump over the same empty squares and produce bit-identical results.
+ *
+ * @param t_grid The map tiles.
+ * @param t_originX The x-coordinate of the shared origin on the screen.
+ * @param t_originY The y-coordinate of the shared origin on the screen.
+ * @param t_packet The packet with the ray directions; receives the results.
+ * @param t_count The number of valid rays in the packet (1 to RayPacket::SIZE).
+ * @param t_simd False forces the scalar path.
+ * @return The number of jumps over empty squares of all rays.
+ */
+int trace_ray_packet(
+    const TraceGrid& t_grid,
+    float t_originX, float t_originY,
+    RayPacket& t_packet,
+    int t_count,
+    bool t_simd = true
+);
+
+/**
+ * @brief Checks whether trace_ray_packet() can use the SIMD kernel on this CPU.
+ *
+ * @return True if the AVX2 kernel is available, otherwise false.
+ */
+[[nodiscard]] bool is_simd_ray_packet_supported();
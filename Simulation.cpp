@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cmath>
+#include "Simulation.h"
+#include "Utils.h"
+#include "Trace.h"
+
+/**
+ * @brief The pose at a fraction of the way from the previous to the current tick.
+ *
+ * Equal poses are returned exactly, so a player standing still keeps an unchanged pose.
+ */
+static Simulation::Pose interpolate(const Simulation::Snapshot& t_snapshot, const float t_alpha)
+{
+    constexpr auto pi{ static_cast<float>(M_PI) };
+
+    // turn the short way across 0 and 2π
+    const auto turn{ wrap_radians(t_snapshot.current.radians - t_snapshot.previous.radians + pi) - pi };
+
+    return {
+        t_snapshot.previous.screenPosition + (t_snapshot.current.screenPosition - t_snapshot.previous.screenPosition) * t_alpha,
+        wrap_radians(t_snapshot.previous.radians + turn * t_alpha)
+    };
+}
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+Simulation::Simulation(const Config& t_config, const Map& t_map, std::mutex& t_mapMutex)
+    : m_mapMutex{ t_mapMutex }
+    , m_player{ t_config, t_map, false }
+    , m_tickTime{ 1.0f / static_cast<float>(std::max(t_config.simulation.tickRate, 1)) }
+{
+    // the start pose, until the first tick
+    auto& snapshot{ m_snapshots.GetWriteBuffer() };
+    snapshot.current = { m_player.GetScreenPosition(), m_player.radians };
+    snapshot.previous = snapshot.current;
+    snapshot.time = Clock::now();
+    m_snapshots.Publish();
+}
+
+Simulation::~Simulation() noexcept
+{
+    Stop();
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void Simulation::Start()
+{
+    if (m_thread.joinable())
+    {
+        return;
+    }
+
+    m_stop.store(false, std::memory_order_relaxed);
+    m_thread = std::thread{ &Simulation::Run, this };
+}
+
+void Simulation::Stop()
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    m_stop.store(true, std::memory_order_release);
+    m_thread.join();
+}
+
+void Simulation::SetInput(const InputState& t_input)
+{
+    m_inputs.GetWriteBuffer() = t_input;
+    m_inputs.Publish();
+}
+
+void Simulation::Advance(const float t_dt, const InputState& t_input)
+{
+    // a tick that is a rounding error short still counts, so 1/60 s frames run exactly 2 ticks at 120 Hz
+    constexpr auto epsilon{ 1.0e-6 };
+
+    m_accumulator += t_dt;
+    while (m_accumulator + epsilon >= m_tickTime)
+    {
+        Tick(t_input, Clock::time_point{});
+        m_accumulator = std::max(m_accumulator - m_tickTime, 0.0);
+    }
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+Simulation::Pose Simulation::GetPose()
+{
+    m_snapshots.Update();
+    const auto& snapshot{ m_snapshots.GetReadBuffer() };
+
+    // one tick behind: the pose moves from the previous to the current tick while the next one is simulated
+    auto alpha{ static_cast<float>(m_accumulator / m_tickTime) };
+    if (m_thread.joinable())
+    {
+        const std::chrono::duration<float> sinceTick{ Clock::now() - snapshot.time };
+        alpha = sinceTick.count() / m_tickTime;
+    }
+
+    return interpolate(snapshot, std::clamp(alpha, 0.0f, 1.0f));
+}
+
+std::uint64_t Simulation::GetTickCount() const
+{
+    return m_snapshots.GetReadBuffer().tick;
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+void Simulation::Run()
+{
+    const auto tickDuration{ std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_tickTime)) };
+    auto next{ Clock::now() };
+
+    while (!m_stop.load(std::memory_order_acquire))
+    {
+        const auto now{ Clock::now() };
+        if (now < next)
+        {
+            std::this_thread::sleep_until(next);
+            continue;
+        }
+
+        if (now - next > MAX_CATCH_UP_TICKS * tickDuration)
+        {
+            next = now;
+        }
+
+        m_inputs.Update();
+        Tick(m_inputs.GetReadBuffer(), next);
+        next += tickDuration;
+    }
+}
+
+void Simulation::Tick(const InputState& t_input, const Clock::time_point t_time)
+{
+    FPS_TRACE_SCOPE("Tick");
+
+    auto& snapshot{ m_snapshots.GetWriteBuffer() };
+    snapshot.previous = { m_player.GetScreenPosition(), m_player.radians };
+    {
+        std::lock_guard lock{ m_mapMutex };
+        m_player.HandleInput(m_tickTime, t_input);
+    }
+    snapshot.current = { m_player.GetScreenPosition(), m_player.radians };
+    snapshot.tick = ++m_tick;
+    snapshot.time = t_time;
+
+    m_snapshots.Publish();
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "Config.h"
+#include "Input.h"
+#include "Player.h"
+#include "TripleBuffer.h"
+
+class Map;
+
+//-------------------------------------------------
+// Simulation
+//-------------------------------------------------
+
+/**
+ * @brief Moves the player in fixed ticks, independent of the frame rate.
+ *
+ * After Start() the ticks run on their own thread and every tick publishes an immutable
+ * snapshot of the last two poses through a TripleBuffer. The renderer reads the newest
+ * snapshot with GetPose() and interpolates between its poses, so it lags one tick behind
+ * but never waits for the simulation. A slow frame doesn't slow the ticks, and a slow
+ * tick only repeats the last pose.
+ *
+ * Without Start(), Advance() runs the ticks inline, which keeps headless runs deterministic.
+ */
+class Simulation
+{
+public:
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Pose
+    {
+        olc::vf2d screenPosition{ 0.0f, 0.0f };
+        float radians{ 0.0f };
+    };
+
+    /**
+     * @brief The result of a tick.
+     */
+    struct Snapshot
+    {
+        Pose previous;
+        Pose current;
+        std::uint64_t tick{ 0 };
+
+        /**
+         * @brief The scheduled time of the tick; only set by the simulation thread.
+         */
+        Clock::time_point time;
+    };
+
+    //-------------------------------------------------
+    // Constants
+    //-------------------------------------------------
+
+    /**
+     * @brief After a longer stall the missed ticks are dropped instead of run back to back.
+     */
+    static constexpr int MAX_CATCH_UP_TICKS{ 8 };
+
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    /**
+     * @brief Constructs a new Simulation object with the player at the configured start tile.
+     *
+     * @param t_config The config snapshot, which must outlive the simulation.
+     * @param t_map The map to move on, which must outlive the simulation.
+     * @param t_mapMutex Held during every tick; whoever changes the map must hold it as well.
+     */
+    Simulation(const Config& t_config, const Map& t_map, std::mutex& t_mapMutex);
+
+    Simulation(const Simulation& t_other) = delete;
+    Simulation(Simulation&& t_other) noexcept = delete;
+    Simulation& operator=(const Simulation& t_other) = delete;
+    Simulation& operator=(Simulation&& t_other) noexcept = delete;
+
+    ~Simulation() noexcept;
+
+    //-------------------------------------------------
+    // Logic
+    //-------------------------------------------------
+
+    /**
+     * @brief Starts the simulation thread; the first tick runs immediately.
+     */
+    void Start();
+
+    /**
+     * @brief Stops the simulation thread after its current tick; the newest snapshot stays readable.
+     */
+    void Stop();
+
+    /**
+     * @brief Hands the held controls to the simulation thread; the ticks use the newest ones.
+     *
+     * @param t_input The held controls of the current frame.
+     */
+    void SetInput(const InputState& t_input);
+
+    /**
+     * @brief Runs the ticks that fit into the elapsed time on the calling thread.
+     *
+     * Must not be mixed with Start(). The time that is left over decides the interpolation of GetPose().
+     *
+     * @param t_dt The elapsed time in seconds.
+     * @param t_input The held controls during that time.
+     */
+    void Advance(float t_dt, const InputState& t_input);
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    /**
+     * @brief The pose between the two newest ticks that matches the current time.
+     */
+    [[nodiscard]] Pose GetPose();
+
+    /**
+     * @brief The number of ticks of the newest snapshot.
+     */
+    [[nodiscard]] std::uint64_t GetTickCount() const;
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    std::mutex& m_mapMutex;
+
+    /**
+     * @brief Moves and collides like the rendered player, without casting rays; only touched by the ticks.
+     */
+    Player m_player;
+
+    float m_tickTime{ 0.0f };
+
+    /**
+     * @brief The time of Advance() that didn't fill a whole tick.
+     */
+    double m_accumulator{ 0.0 };
+
+    std::uint64_t m_tick{ 0 };
+
+    TripleBuffer<Snapshot> m_snapshots;
+    TripleBuffer<InputState> m_inputs;
+
+    std::thread m_thread;
+    std::atomic<bool> m_stop{ false };
+
+    //-------------------------------------------------
+    // Helper
+    //-------------------------------------------------
+
+    /**
+     * @brief The simulation thread: ticks at the tick rate until stopped.
+     */
+    void Run();
+
+    /**
+     * @brief Moves the player by one tick and publishes the snapshot.
+     */
+    void Tick(const InputState& t_input, Clock::time_point t_time);
+};
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cmath>
+#include "Texture.h"
+#include "Log.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+Texture::Texture(const std::string& t_path)
+{
+    const olc::Sprite sprite{ t_path };
+    if (sprite.width > 0 && sprite.height > 0)
+    {
+        Transpose(sprite);
+        return;
+    }
+
+    FPS_LOG_WARN("[Texture::Texture()] Unable to load {}, using a checkerboard texture.", t_path);
+
+    olc::Sprite checkerboard{ 64, 64 };
+    for (auto y{ 0 }; y < 64; ++y)
+    {
+        for (auto x{ 0 }; x < 64; ++x)
+        {
+            checkerboard.SetPixel(x, y, ((x / 8 + y / 8) % 2) ? olc::GREY : olc::DARK_RED);
+        }
+    }
+
+    Transpose(checkerboard);
+}
+
+Texture::Texture(const olc::Sprite& t_sprite)
+{
+    Transpose(t_sprite);
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+int Texture::GetWidth(const int t_level) const
+{
+    return m_levels[t_level].width;
+}
+
+int Texture::GetHeight(const int t_level) const
+{
+    return m_levels[t_level].height;
+}
+
+int Texture::GetLevelCount() const
+{
+    return static_cast<int>(m_levels.size());
+}
+
+//-------------------------------------------------
+// Mipmapping
+//-------------------------------------------------
+
+int Texture::SelectMipLevel(const float t_wallHeight, const int t_textureHeight, const int t_levelCount, const int t_bias)
+{
+    // ilogb() is floor(log2()) for positive values, without the transcendental call
+    const auto ratio{ static_cast<float>(t_textureHeight) / t_wallHeight };
+    const auto level{ ratio >= 1.0f ? std::ilogb(ratio) + t_bias : t_bias };
+
+    return std::clamp(level, 0, t_levelCount - 1);
+}
+
+int Texture::SelectColumn(const float t_hitPosition, const float t_tileSize, const int t_levelWidth)
+{
+    const auto inTile{ std::fmod(t_hitPosition, t_tileSize) / t_tileSize };
+    const auto column{ static_cast<int>(inTile * static_cast<float>(t_levelWidth)) };
+
+    return std::clamp(column, 0, t_levelWidth - 1);
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+void Texture::Transpose(const olc::Sprite& t_sprite)
+{
+    const auto width{ t_sprite.width };
+    const auto height{ t_sprite.height };
+
+    m_levels.push_back({ width, height, 0 });
+    m_texels.resize(width * height);
+
+    for (auto x{ 0 }; x < width; ++x)
+    {
+        for (auto y{ 0 }; y < height; ++y)
+        {
+            m_texels[x * height + y] = t_sprite.GetPixel(x, y);
+        }
+    }
+
+    CreateMipLevels();
+}
+
+void Texture::CreateMipLevels()
+{
+    while (m_levels.back().width > 1 || m_levels.back().height > 1)
+    {
+        const auto source{ m_levels.back() };
+        const MipLevel level{
+            std::max(1, source.width / 2),
+            std::max(1, source.height / 2),
+            m_texels.size()
+        };
+
+        m_texels.resize(level.offset + level.width * level.height);
+        m_levels.push_back(level);
+
+        // 2x2 box filter; odd sizes clamp to the last source texel
+        for (auto x{ 0 }; x < level.width; ++x)
+        {
+            const auto x0{ std::min(2 * x, source.width - 1) };
+            const auto x1{ std::min(2 * x + 1, source.width - 1) };
+
+            for (auto y{ 0 }; y < level.height; ++y)
+            {
+                const auto y0{ std::min(2 * y, source.height - 1) };
+                const auto y1{ std::min(2 * y + 1, source.height - 1) };
+
+                const auto& a{ m_texels[source.offset + x0 * source.height + y0] };
+                const auto& b{ m_texels[source.offset + x0 * source.height + y1] };
+                const auto& c{ m_texels[source.offset + x1 * source.height + y0] };
+                const auto& d{ m_texels[source.offset + x1 * source.height + y1] };
+
+                m_texels[level.offset + x * level.height + y] = olc::Pixel(
+                    static_cast<std::uint8_t>((a.r + b.r + c.r + d.r + 2) / 4),
+                    static_cast<std::uint8_t>((a.g + b.g + c.g + d.g + 2) / 4),
+                    static_cast<std::uint8_t>((a.b + b.b + c.b + d.b + 2) / 4),
+                    static_cast<std::uint8_t>((a.a + b.a + c.a + d.a + 2) / 4)
+                );
+            }
+        }
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "olcPixelGameEngine.h"
+
+//-------------------------------------------------
+// Texture
+//-------------------------------------------------
+
+/**
+ * @brief A mipmapped wall texture stored column by column.
+ *
+ * Walls are sampled vertically at a fixed texture column. Storing the texels
+ * transposed puts the samples of a screen column next to each other in memory.
+ * Each mip level halves the size of the previous one, down to a single texel.
+ */
+class Texture
+{
+public:
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    /**
+     * @brief Loads an image file; falls back to a checkerboard if the file cannot be loaded.
+     *
+     * @param t_path The path of the image file.
+     */
+    explicit Texture(const std::string& t_path);
+
+    /**
+     * @brief Copies and transposes the pixels of a sprite.
+     *
+     * @param t_sprite The sprite to copy.
+     */
+    explicit Texture(const olc::Sprite& t_sprite);
+
+    Texture(const Texture& t_other) = delete;
+    Texture(Texture&& t_other) noexcept = delete;
+    Texture& operator=(const Texture& t_other) = delete;
+    Texture& operator=(Texture&& t_other) noexcept = delete;
+
+    ~Texture() noexcept = default;
+
+    //-------------------------------------------------
+    // Getter
+    //-------------------------------------------------
+
+    [[nodiscard]] int GetWidth(int t_level = 0) const;
+    [[nodiscard]] int GetHeight(int t_level = 0) const;
+    [[nodiscard]] int GetLevelCount() const;
+
+    /**
+     * @brief Returns the contiguous texels of a column, from top to bottom.
+     *
+     * @param t_x The texture column, must be in [0, GetWidth(t_level)).
+     * @param t_level The mip level.
+     *
+     * @return Pointer to the first of GetHeight(t_level) texels.
+     */
+    [[nodiscard]] const olc::Pixel* GetColumn(const int t_x, const int t_level = 0) const
+    {
+        const auto& level{ m_levels[t_level] };
+        return m_texels.data() + level.offset + t_x * level.height;
+    }
+
+    //-------------------------------------------------
+    // Mipmapping
+    //-------------------------------------------------
+
+    /**
+     * @brief Selects the mip level for a wall column of the given projected height.
+     *
+     * Picks the smallest level that still has at least one texel per screen pixel,
+     * i.e. floor(log2(textureHeight / wallHeight)), shifted by t_bias and clamped
+     * to the available levels.
+     *
+     * @param t_wallHeight The projected height of the wall in pixels.
+     * @param t_textureHeight The height of mip level 0.
+     * @param t_levelCount The number of mip levels.
+     * @param t_bias Added to the level; positive values select blurrier levels.
+     *
+     * @return The mip level.
+     */
+    [[nodiscard]] static int SelectMipLevel(float t_wallHeight, int t_textureHeight, int t_levelCount, int t_bias = 0);
+
+    /**
+     * @brief Selects the texture column of a wall hit in a mip level.
+     *
+     * The texture spans one tile, so the column is the hit's position inside its tile scaled
+     * to the width of the level. It is clamped, so levels of any width are safe to sample.
+     *
+     * @param t_hitPosition The screen coordinate of the hit along the wall.
+     * @param t_tileSize The size of a tile in screen units.
+     * @param t_levelWidth The width of the mip level, see GetWidth().
+     *
+     * @return The column, in [0, t_levelWidth).
+     */
+    [[nodiscard]] static int SelectColumn(float t_hitPosition, float t_tileSize, int t_levelWidth);
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    struct MipLevel
+    {
+        int width{ 0 };
+        int height{ 0 };
+
+        /**
+         * @brief Index of the first texel of the level in m_texels.
+         */
+        std::size_t offset{ 0 };
+    };
+
+    std::vector<MipLevel> m_levels;
+
+    /**
+     * @brief The column-major texels of all mip levels, one level after the other.
+     */
+    std::vector<olc::Pixel> m_texels;
+
+    //-------------------------------------------------
+    // Helper
+    //-------------------------------------------------
+
+    void Transpose(const olc::Sprite& t_sprite);
+    void CreateMipLevels();
+};
@@ -0,0 +1,166 @@
+#include <iomanip>
+#include "Trace.h"
+#include "Log.h"
+
+//-------------------------------------------------
+// Init
+//-------------------------------------------------
+
+void Trace::Begin(const std::string& t_path)
+{
+    if (IsEnabled())
+    {
+        FPS_LOG_WARN("[Trace::Begin()] Tracing is already running.");
+        return;
+    }
+
+    m_file.open(t_path, std::ios::out | std::ios::trunc);
+    if (!m_file)
+    {
+        FPS_LOG_ERROR("[Trace::Begin()] Unable to open {}, tracing is disabled.", t_path);
+        return;
+    }
+
+    m_events = std::make_unique<Event[]>(EVENT_CAPACITY);
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_start = std::chrono::steady_clock::now();
+    m_firstEvent = true;
+    m_stop = false;
+
+    m_file << std::setfill('0');
+    m_file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    m_flushThread = std::thread{ &Trace::FlushLoop };
+    m_enabled.store(true, std::memory_order_release);
+
+    FPS_LOG_INFO("[Trace::Begin()] Writing trace events to {}.", t_path);
+}
+
+void Trace::End()
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    // a thread that saw tracing enabled finishes its event before the last flush
+    m_enabled.store(false, std::memory_order_seq_cst);
+    while (m_writers.load(std::memory_order_seq_cst) > 0)
+    {
+        std::this_thread::yield();
+    }
+
+    {
+        std::lock_guard lock{ m_mutex };
+        m_stop = true;
+    }
+    m_stopCondition.notify_one();
+    m_flushThread.join();
+
+    Flush();
+    m_file << "\n]}\n";
+    m_file.close();
+
+    if (const auto dropped{ m_dropped.load() }; dropped > 0)
+    {
+        FPS_LOG_WARN("[Trace::End()] {} events were dropped, the buffer was full.", dropped);
+    }
+
+    FPS_LOG_INFO("[Trace::End()] Trace file written.");
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void Trace::AddEvent(const char* t_name, const std::chrono::steady_clock::time_point t_begin)
+{
+    const auto now{ std::chrono::steady_clock::now() };
+
+    // registered before the check, so End() either sees the writer or the writer sees tracing disabled
+    m_writers.fetch_add(1, std::memory_order_seq_cst);
+    if (!m_enabled.load(std::memory_order_seq_cst))
+    {
+        m_writers.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+
+    // only take a ticket if its slot was flushed, so the flush thread never waits for a dropped event
+    auto ticket{ m_head.load(std::memory_order_relaxed) };
+    do
+    {
+        if (ticket - m_tail.load(std::memory_order_acquire) >= EVENT_CAPACITY)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            m_writers.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+    } while (!m_head.compare_exchange_weak(ticket, ticket + 1, std::memory_order_relaxed));
+
+    auto& event{ m_events[ticket % EVENT_CAPACITY] };
+    event.name = t_name;
+    event.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(t_begin - m_start).count();
+    event.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(now - t_begin).count();
+    event.threadId = GetThreadId();
+    event.sequence.store(ticket + 1, std::memory_order_release);
+
+    m_writers.fetch_sub(1, std::memory_order_release);
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+void Trace::FlushLoop()
+{
+    std::unique_lock lock{ m_mutex };
+    while (!m_stop)
+    {
+        m_stopCondition.wait_for(lock, std::chrono::milliseconds(10), [] { return m_stop; });
+
+        lock.unlock();
+        Flush();
+        lock.lock();
+    }
+}
+
+void Trace::Flush()
+{
+    auto tail{ m_tail.load(std::memory_order_relaxed) };
+
+    // events are written in ticket order; stop at the first one still being written
+    for (;;)
+    {
+        auto& event{ m_events[tail % EVENT_CAPACITY] };
+        if (event.sequence.load(std::memory_order_acquire) != tail + 1)
+        {
+            break;
+        }
+
+        if (!m_firstEvent)
+        {
+            m_file << ",\n";
+        }
+        m_firstEvent = false;
+
+        // the timestamps are microseconds
+        m_file << "{\"name\":\"" << event.name
+               << "\",\"ph\":\"X\",\"ts\":" << event.timestamp / 1000 << '.' << std::setw(3) << event.timestamp % 1000
+               << ",\"dur\":" << event.duration / 1000 << '.' << std::setw(3) << event.duration % 1000
+               << ",\"pid\":1,\"tid\":" << event.threadId << '}';
+
+        ++tail;
+        m_tail.store(tail, std::memory_order_release);
+    }
+
+    m_file.flush();
+}
+
+std::uint32_t Trace::GetThreadId()
+{
+    thread_local const auto threadId{ m_nextThreadId.fetch_add(1, std::memory_order_relaxed) };
+
+    return threadId;
+}
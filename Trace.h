@@ -0,0 +1,179 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+//-------------------------------------------------
+// Trace
+//-------------------------------------------------
+
+/**
+ * @brief Writes complete ('X') events in the Chrome trace-event format.
+ *
+ * The resulting JSON file can be opened with chrome://tracing or Perfetto. Events are
+ * written into a preallocated ring buffer from any thread without locking and written
+ * to the file by a background thread, so tracing barely affects the measured frames.
+ * If the buffer is full, events are dropped and counted instead of blocking. Each event
+ * carries its begin and its duration, so a dropped event never leaves an unmatched begin.
+ */
+class Trace
+{
+public:
+    //-------------------------------------------------
+    // Constants
+    //-------------------------------------------------
+
+    /**
+     * @brief The number of events the buffer can hold before the flush thread catches up.
+     */
+    static constexpr auto EVENT_CAPACITY{ 1 << 16 };
+
+    //-------------------------------------------------
+    // Init
+    //-------------------------------------------------
+
+    /**
+     * @brief Opens the trace file and starts the flush thread.
+     *
+     * @param t_path The path of the JSON file to write.
+     */
+    static void Begin(const std::string& t_path);
+
+    /**
+     * @brief Waits for the events being added, writes the remaining ones, closes the file and stops the flush thread.
+     */
+    static void End();
+
+    //-------------------------------------------------
+    // Logic
+    //-------------------------------------------------
+
+    [[nodiscard]] static bool IsEnabled()
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Adds an event of the calling thread that began at t_begin and ends now.
+     *
+     * @param t_name The event name; must be a string literal, since only the pointer is stored.
+     * @param t_begin The time the event began.
+     */
+    static void AddEvent(const char* t_name, std::chrono::steady_clock::time_point t_begin);
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Types
+    //-------------------------------------------------
+
+    struct Event
+    {
+        /**
+         * @brief The ticket + 1 of the event once it is completely written.
+         */
+        std::atomic<std::uint64_t> sequence{ 0 };
+
+        const char* name{ nullptr };
+        std::int64_t timestamp{ 0 };
+        std::int64_t duration{ 0 };
+        std::uint32_t threadId{ 0 };
+    };
+
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    inline static std::atomic<bool> m_enabled{ false };
+    inline static std::unique_ptr<Event[]> m_events;
+    inline static std::atomic<std::uint64_t> m_head{ 0 };
+    inline static std::atomic<std::uint64_t> m_tail{ 0 };
+    inline static std::atomic<std::uint64_t> m_dropped{ 0 };
+    inline static std::atomic<std::uint32_t> m_nextThreadId{ 0 };
+
+    /**
+     * @brief The threads inside AddEvent(); End() waits until none is left.
+     */
+    inline static std::atomic<std::uint32_t> m_writers{ 0 };
+
+    inline static std::chrono::steady_clock::time_point m_start;
+    inline static std::ofstream m_file;
+    inline static bool m_firstEvent{ true };
+
+    inline static std::thread m_flushThread;
+    inline static std::mutex m_mutex;
+    inline static std::condition_variable m_stopCondition;
+    inline static bool m_stop{ false };
+
+    //-------------------------------------------------
+    // Helper
+    //-------------------------------------------------
+
+    static void FlushLoop();
+    static void Flush();
+    static std::uint32_t GetThreadId();
+};
+
+//-------------------------------------------------
+// ScopedTraceEvent
+//-------------------------------------------------
+
+/**
+ * @brief Adds an event spanning its lifetime on destruction.
+ */
+class ScopedTraceEvent
+{
+public:
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    explicit ScopedTraceEvent(const char* t_name)
+        : m_name{ Trace::IsEnabled() ? t_name : nullptr }
+    {
+        if (m_name)
+        {
+            m_begin = std::chrono::steady_clock::now();
+        }
+    }
+
+    ScopedTraceEvent(const ScopedTraceEvent& t_other) = delete;
+    ScopedTraceEvent(ScopedTraceEvent&& t_other) noexcept = delete;
+    ScopedTraceEvent& operator=(const ScopedTraceEvent& t_other) = delete;
+    ScopedTraceEvent& operator=(ScopedTraceEvent&& t_other) noexcept = delete;
+
+    ~ScopedTraceEvent() noexcept
+    {
+        if (m_name)
+        {
+            Trace::AddEvent(m_name, m_begin);
+        }
+    }
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    const char* m_name;
+    std::chrono::steady_clock::time_point m_begin;
+};
+
+//-------------------------------------------------
+// Macros
+//-------------------------------------------------
+
+#define FPS_TRACE_CONCAT_IMPL(a, b) a##b
+#define FPS_TRACE_CONCAT(a, b)      FPS_TRACE_CONCAT_IMPL(a, b)
+
+#define FPS_TRACE_SCOPE(name) ScopedTraceEvent FPS_TRACE_CONCAT(scopedTraceEvent, __LINE__){ name }
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+//-------------------------------------------------
+// TripleBuffer
+//-------------------------------------------------
+
+/**
+ * @brief Hands the newest value from one writer thread to one reader thread without locks.
+ *
+ * The writer and the reader each own one of three slots, the third is shared. Publishing
+ * swaps the writer's slot with the shared one, and the reader swaps its slot with the shared
+ * one if it holds a newer value. Neither side ever waits for the other. The reader skips
+ * values that were published in between, so it always sees the newest complete one.
+ *
+ * @tparam T The value type; its slots are reused, so keeping allocations inside is fine.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    //-------------------------------------------------
+    // Ctors. / Dtor.
+    //-------------------------------------------------
+
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer& t_other) = delete;
+    TripleBuffer(TripleBuffer&& t_other) noexcept = delete;
+    TripleBuffer& operator=(const TripleBuffer& t_other) = delete;
+    TripleBuffer& operator=(TripleBuffer&& t_other) noexcept = delete;
+
+    ~TripleBuffer() noexcept = default;
+
+    //-------------------------------------------------
+    // Writer
+    //-------------------------------------------------
+
+    /**
+     * @brief The slot to fill before the next Publish(); it holds an older value.
+     */
+    [[nodiscard]] T& GetWriteBuffer() { return m_buffers[m_writeIndex]; }
+
+    /**
+     * @brief Makes the write buffer the newest value and takes over the shared slot for writing.
+     */
+    void Publish()
+    {
+        m_writeIndex = m_shared.exchange(static_cast<std::uint8_t>(m_writeIndex | FRESH_BIT), std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    //-------------------------------------------------
+    // Reader
+    //-------------------------------------------------
+
+    /**
+     * @brief Switches the read buffer to the newest published value.
+     *
+     * @return True if a value was published since the last call, otherwise false.
+     */
+    bool Update()
+    {
+        if ((m_shared.load(std::memory_order_relaxed) & FRESH_BIT) == 0)
+        {
+            return false;
+        }
+
+        m_readIndex = m_shared.exchange(m_readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+
+        return true;
+    }
+
+    /**
+     * @brief The value of the last Update(); stays unchanged until the next one.
+     */
+    [[nodiscard]] const T& GetReadBuffer() const { return m_buffers[m_readIndex]; }
+
+protected:
+
+private:
+    //-------------------------------------------------
+    // Constants
+    //-------------------------------------------------
+
+    /**
+     * @brief Set in the shared index while it holds a value the reader hasn't seen.
+     */
+    static constexpr std::uint8_t FRESH_BIT{ 4 };
+    static constexpr std::uint8_t INDEX_MASK{ 3 };
+
+    //-------------------------------------------------
+    // Member
+    //-------------------------------------------------
+
+    std::array<T, 3> m_buffers{};
+
+    /**
+     * @brief The slot owned by neither side, plus FRESH_BIT.
+     */
+    alignas(64) std::atomic<std::uint8_t> m_shared{ 1 };
+
+    /**
+     * @brief Only touched by the writer and the reader respectively; on their own cache lines.
+     */
+    alignas(64) std::uint8_t m_writeIndex{ 0 };
+    alignas(64) std::uint8_t m_readIndex{ 2 };
+};
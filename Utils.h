@@ -138,6 +138,30 @@ inline void adjust_screen_position_by_angle(
     return normalized;
 }
 
+/**
+ * @brief Wraps an angle that is at most one turn outside of [0, 2π) back into that range.
+ *
+ * A cheaper alternative to clamp_radians() for angles that are a sum of two normalized values.
+ *
+ * @param t_radians The angle in radians, within (-2π, 4π).
+ *
+ * @return The angle in radians within the range [0, 2π).
+ */
+[[nodiscard]] inline float wrap_radians(const float t_radians)
+{
+    constexpr float twoPi{ 2.0f * M_PI };
+    if (t_radians < 0.0f)
+    {
+        return t_radians + twoPi;
+    }
+    if (t_radians >= twoPi)
+    {
+        return t_radians - twoPi;
+    }
+
+    return t_radians;
+}
+
 /**
  * @brief Determines if the direction represented by the given angle in radians is facing right.
  *
@@ -161,44 +185,3 @@ inline void adjust_screen_position_by_angle(
 {
     return t_radians >= M_PI;
 }
-
-//-------------------------------------------------
-// Arrays
-//-------------------------------------------------
-
-/**
- * @brief Clears a given vector by swapping it with an empty one.
- *
- * This function releases the memory used by a vector by swapping it with an empty vector.
- * After calling this function, the original vector will be empty, and its memory will be freed.
- *
- * @tparam T The type of elements stored in the vector.
- * @param t_vec The vector to be cleared.
- */
-template <typename T>
-void clear_vector(std::vector<T>& t_vec)
-{
-    std::vector<T>().swap(t_vec);
-}
-
-//-------------------------------------------------
-// Strings
-//-------------------------------------------------
-
-/**
- * @brief Converts a floating point value to a string with a specified number of decimal places.
- *
- * @tparam T The floating point type (float, double).
- * @param t_value The floating point value to be converted.
- * @param t_precision The number of decimal places to include in the string. Default is 2.
- *
- * @return std::string A string representation of the floating point value with the specified precision.
- */
-template<typename T>
-[[nodiscard]] std::string to_string_with_precision(const T t_value, const int t_precision = 2)
-{
-    static_assert(std::is_floating_point<T>::value, "Template argument must be a floating point type.");
-    std::ostringstream stream;
-    stream << std::fixed << std::setprecision(t_precision) << t_value;
-    return stream.str();
-}
@@ -1,14 +1,36 @@
 #define OLC_PGE_APPLICATION
+#include <charconv>
+#include <string_view>
 #include "Game.h"
 #include "Log.h"
 
-int main()
+int main(int argc, char* argv[])
 {
     Log::Init();
 
     FPS_LOG_DEBUG("[main()] Starting main.");
     FPS_LOG_DEBUG("[main()] Logger was initialized.");
 
+    // Shooter --headless <frames> [input script]
+    if (argc > 1 && std::string_view{ argv[1] } == "--headless")
+    {
+        const std::string_view count{ argc > 2 ? argv[2] : "" };
+        auto frames{ 0 };
+        const auto [end, error]{ std::from_chars(count.data(), count.data() + count.size(), frames) };
+        if (error != std::errc{} || end != count.data() + count.size() || frames <= 0)
+        {
+            FPS_LOG_ERROR("[main()] Usage: {} --headless <frames> [input script], with frames > 0.", argv[0]);
+            return 1;
+        }
+
+        const InputScript script{ argc > 3 ? InputScript{ argv[3] } : InputScript{} };
+
+        Game game;
+        game.RunHeadless(frames, script);
+
+        return 0;
+    }
+
     if (Game game; game.Construct(
         Game::INI.Get<int>("window", "width"),
         Game::INI.Get<int>("window", "height") ,